@@ -0,0 +1,284 @@
+// ****************************************************************
+// * Structural diff between two versions of a PE file. Compares  *
+// * header fields, sections (by name and content hash) and the   *
+// * imported DLLs and functions                                  *
+// ****************************************************************
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+#include <iomanip>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "diff.h"
+#include "fields.h"
+#include "parser.h"
+
+// Everything needed from one side of the diff, the stream has to outlive the parser
+struct DiffInput {
+    std::unique_ptr<std::ifstream> infile;
+    std::unique_ptr<Parser> parser;
+    std::vector<uint64_t> sectionHashes;
+};
+
+// Section name and its index in the section table, sorted by name to merge both sides.
+// The index keeps sections with the same name in table order.
+struct SectionKey {
+    std::string name;
+    size_t index;
+
+    bool operator <(const SectionKey &other) const {
+        return name != other.name ? name < other.name : index < other.index;
+    }
+};
+
+static void printBanner(const char *title) {
+    // Centers the title in the 55 characters between the # blocks, like the headers in logging.cpp
+    size_t left = (55 - strlen(title)) / 2;
+    size_t right = 55 - strlen(title) - left;
+    std::cout << " +---------------------------------------------------------------------------+" << std::endl;
+    std::cout << " |##########" << std::string(left, ' ') << title << std::string(right, ' ') << "##########|" << std::endl;
+    std::cout << " +---------------------------------------------------------------------------+" << std::endl;
+}
+
+// readAscii keeps the terminating null byte, this drops it for printing and comparing
+static std::string cString(const std::string &s) {
+    return std::string(s.c_str());
+}
+
+static std::unique_ptr<DiffInput> parseForDiff(const std::string &path) {
+    std::unique_ptr<DiffInput> input = std::make_unique<DiffInput>();
+    input->infile = std::make_unique<std::ifstream>(path, std::ios::in | std::ios::binary);
+    if (!*input->infile) {
+        throw std::invalid_argument("Error reading file " + path);
+    }
+    try {
+        input->parser = std::make_unique<Parser>(&*input->infile);
+    } catch (const std::invalid_argument &e) {
+        throw std::invalid_argument(std::string(e.what()) + " in " + path);
+    }
+    input->sectionHashes = input->parser->hashSections();
+    return input;
+}
+
+static bool diffHeaders(Parser *oldParser, Parser *newParser) {
+    bool changed = false;
+    for (const HeaderField &field : headerFields) {
+        uint64_t oldValue = field.get(oldParser);
+        uint64_t newValue = field.get(newParser);
+        if (oldValue != newValue) {
+            if (!changed) {
+                printBanner("Changed Header Fields");
+                changed = true;
+            }
+            std::cout << "  [~] " << std::setfill('.') << std::left << std::setw(28) << (std::string(field.name) + " ") << std::right;
+            std::cout << " 0x" << std::hex << std::setfill('0') << std::setw(8) << oldValue << " -> 0x" << std::setw(8) << newValue << "\n";
+        }
+    }
+    return changed;
+}
+
+// Directories missing from the shorter table count as empty ones
+static bool diffDataDirectories(Parser *oldParser, Parser *newParser) {
+    std::vector<ImageDataDirectoryEntry> &oldDirs = oldParser->getDataDirectories();
+    std::vector<ImageDataDirectoryEntry> &newDirs = newParser->getDataDirectories();
+    bool changed = false;
+    for (size_t i = 0; i < std::max(oldDirs.size(), newDirs.size()); i++) {
+        ImageDataDirectoryEntry oldDir = i < oldDirs.size() ? oldDirs[i] : ImageDataDirectoryEntry{0, 0};
+        ImageDataDirectoryEntry newDir = i < newDirs.size() ? newDirs[i] : ImageDataDirectoryEntry{0, 0};
+        if (oldDir.VA == newDir.VA && oldDir.size == newDir.size) {
+            continue;
+        }
+        if (!changed) {
+            printBanner("Changed Data Directories");
+            changed = true;
+        }
+        const char *prefix = oldDir.VA == 0 ? "[+]" : newDir.VA == 0 ? "[-]" : "[~]";
+        std::cout << "  " << prefix << " " << std::setfill(' ') << std::left << std::setw(24) << getDataDirectoryName(i) << std::right << std::hex << std::setfill('0');
+        std::cout << " RVA 0x" << std::setw(8) << oldDir.VA << " -> 0x" << std::setw(8) << newDir.VA;
+        std::cout << "  size 0x" << std::setw(8) << (uint32_t)oldDir.size << " -> 0x" << std::setw(8) << (uint32_t)newDir.size << "\n";
+    }
+    return changed;
+}
+
+static std::vector<SectionKey> getSectionKeys(std::vector<SectionTableEntry> &sections) {
+    std::vector<SectionKey> keys;
+    for (size_t i = 0; i < sections.size(); i++) {
+        keys.push_back({std::string((const char *)sections[i].name, strnlen((const char *)sections[i].name, sizeof(sections[i].name))), i});
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+static void printSectionSizes(std::ostream &out, const char *prefix, const SectionKey &key, const SectionTableEntry &section) {
+    out << "  " << prefix << " " << std::setfill(' ') << std::left << std::setw(8) << key.name << std::right << std::hex << std::setfill('0');
+    out << " raw size 0x" << std::setw(8) << section.sizeOfRawData << "  virtual size 0x" << std::setw(8) << section.virtualSize << "\n";
+}
+
+static bool diffSections(DiffInput *oldInput, DiffInput *newInput) {
+    std::vector<SectionTableEntry> &oldSections = oldInput->parser->getSectionTable();
+    std::vector<SectionTableEntry> &newSections = newInput->parser->getSectionTable();
+    std::vector<SectionKey> oldKeys = getSectionKeys(oldSections);
+    std::vector<SectionKey> newKeys = getSectionKeys(newSections);
+
+    // Sections with the same name are paired up in table order, so the n-th duplicate of a
+    // name is matched with the n-th duplicate on the other side
+    std::ostringstream lines;
+    size_t i = 0, j = 0;
+    while (i < oldKeys.size() || j < newKeys.size()) {
+        if (j == newKeys.size() || (i < oldKeys.size() && oldKeys[i].name < newKeys[j].name)) {
+            printSectionSizes(lines, "[-]", oldKeys[i], oldSections[oldKeys[i].index]);
+            i++;
+            continue;
+        }
+        if (i == oldKeys.size() || newKeys[j].name < oldKeys[i].name) {
+            printSectionSizes(lines, "[+]", newKeys[j], newSections[newKeys[j].index]);
+            j++;
+            continue;
+        }
+
+        SectionTableEntry &oldSection = oldSections[oldKeys[i].index];
+        SectionTableEntry &newSection = newSections[newKeys[j].index];
+        const std::string &name = oldKeys[i].name;
+        if (oldSection.sizeOfRawData != newSection.sizeOfRawData || oldSection.virtualSize != newSection.virtualSize) {
+            lines << "  [~] " << std::setfill(' ') << std::left << std::setw(8) << name << std::right << std::hex << std::setfill('0');
+            lines << " resized, raw size 0x" << std::setw(8) << oldSection.sizeOfRawData << " -> 0x" << std::setw(8) << newSection.sizeOfRawData;
+            lines << "  virtual size 0x" << std::setw(8) << oldSection.virtualSize << " -> 0x" << std::setw(8) << newSection.virtualSize << "\n";
+        } else if (oldInput->sectionHashes[oldKeys[i].index] != newInput->sectionHashes[newKeys[j].index]) {
+            lines << "  [~] " << std::setfill(' ') << std::left << std::setw(8) << name << std::right << " content changed\n";
+        }
+        if (oldSection.virtualAddress != newSection.virtualAddress) {
+            lines << "  [~] " << std::setfill(' ') << std::left << std::setw(8) << name << std::right << std::hex << std::setfill('0');
+            lines << " moved, virtual address 0x" << std::setw(8) << oldSection.virtualAddress << " -> 0x" << std::setw(8) << newSection.virtualAddress << "\n";
+        }
+        i++;
+        j++;
+    }
+
+    if (lines.tellp() == 0) {
+        return false;
+    }
+    printBanner("Changed Sections");
+    std::cout << lines.str();
+    return true;
+}
+
+// Sorted, de-duplicated function names of one DLL, ordinal imports are named #<ordinal>
+static std::vector<std::string> getFunctionNames(const std::vector<HintTableEntry> &functions) {
+    std::vector<std::string> names;
+    names.reserve(functions.size());
+    for (const HintTableEntry &function : functions) {
+        names.push_back(function.isOrdinalImport ? "#" + std::to_string(function.hint) : cString(function.name));
+    }
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    return names;
+}
+
+// Windows resolves DLL names case-insensitively, so DLLs are paired on their lower cased name
+struct DllKey {
+    std::string name;
+    std::map<DllNameFunctionNumber, std::vector<HintTableEntry>>::iterator it;
+
+    bool operator <(const DllKey &other) const {
+        return name < other.name;
+    }
+};
+
+static std::vector<DllKey> getDllKeys(std::map<DllNameFunctionNumber, std::vector<HintTableEntry>> &imports) {
+    std::vector<DllKey> keys;
+    keys.reserve(imports.size());
+    for (std::map<DllNameFunctionNumber, std::vector<HintTableEntry>>::iterator it = imports.begin(); it != imports.end(); it++) {
+        std::string name = cString(it->first.name);
+        for (char &c : name) {
+            if (c >= 'A' && c <= 'Z') {
+                c = c - 'A' + 'a';
+            }
+        }
+        keys.push_back({name, it});
+    }
+    std::stable_sort(keys.begin(), keys.end());
+    return keys;
+}
+
+static bool diffImports(Parser *oldParser, Parser *newParser) {
+    std::vector<DllKey> oldKeys = getDllKeys(oldParser->getImports());
+    std::vector<DllKey> newKeys = getDllKeys(newParser->getImports());
+    bool changed = false;
+
+    // Both key lists are sorted by DLL name so the sets can be merged in one pass
+    size_t oldIndex = 0, newIndex = 0;
+    while (oldIndex < oldKeys.size() || newIndex < newKeys.size()) {
+        bool removed = newIndex == newKeys.size() || (oldIndex < oldKeys.size() && oldKeys[oldIndex] < newKeys[newIndex]);
+        bool added = !removed && (oldIndex == oldKeys.size() || newKeys[newIndex] < oldKeys[oldIndex]);
+        std::map<DllNameFunctionNumber, std::vector<HintTableEntry>>::iterator oldIt = oldIndex < oldKeys.size() ? oldKeys[oldIndex].it : std::map<DllNameFunctionNumber, std::vector<HintTableEntry>>::iterator();
+        std::map<DllNameFunctionNumber, std::vector<HintTableEntry>>::iterator newIt = newIndex < newKeys.size() ? newKeys[newIndex].it : std::map<DllNameFunctionNumber, std::vector<HintTableEntry>>::iterator();
+
+        std::vector<std::string> lines;
+        if (removed) {
+            lines.push_back("  [-] " + cString(oldIt->first.name) + "\t" + std::to_string(oldIt->second.size()) + " function(s)");
+            oldIndex++;
+        } else if (added) {
+            lines.push_back("  [+] " + cString(newIt->first.name) + "\t" + std::to_string(newIt->second.size()) + " function(s)");
+            newIndex++;
+        } else {
+            std::vector<std::string> oldNames = getFunctionNames(oldIt->second);
+            std::vector<std::string> newNames = getFunctionNames(newIt->second);
+            size_t i = 0, j = 0;
+            while (i < oldNames.size() || j < newNames.size()) {
+                if (j == newNames.size() || (i < oldNames.size() && oldNames[i] < newNames[j])) {
+                    lines.push_back("\t[-] " + oldNames[i++]);
+                } else if (i == oldNames.size() || newNames[j] < oldNames[i]) {
+                    lines.push_back("\t[+] " + newNames[j++]);
+                } else {
+                    i++;
+                    j++;
+                }
+            }
+            if (!lines.empty()) {
+                lines.insert(lines.begin(), "  [~] " + cString(oldIt->first.name));
+            }
+            oldIndex++;
+            newIndex++;
+        }
+
+        if (!lines.empty()) {
+            if (!changed) {
+                printBanner("Changed Imports");
+                changed = true;
+            }
+            for (std::string &line : lines) {
+                std::cout << line << "\n";
+            }
+        }
+    }
+    return changed;
+}
+
+int diffFiles(const char *oldPath, const char *newPath) {
+    std::unique_ptr<DiffInput> oldInput, newInput;
+    try {
+        // Both files are parsed and hashed at the same time
+        std::future<std::unique_ptr<DiffInput>> oldFuture = std::async(std::launch::async, parseForDiff, std::string(oldPath));
+        std::future<std::unique_ptr<DiffInput>> newFuture = std::async(std::launch::async, parseForDiff, std::string(newPath));
+        oldInput = oldFuture.get();
+        newInput = newFuture.get();
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 2;
+    }
+
+    bool changed = diffHeaders(&*oldInput->parser, &*newInput->parser);
+    changed = diffDataDirectories(&*oldInput->parser, &*newInput->parser) || changed;
+    changed = diffSections(&*oldInput, &*newInput) || changed;
+    changed = diffImports(&*oldInput->parser, &*newInput->parser) || changed;
+    if (!changed) {
+        std::cout << "Files are structurally identical\n";
+    }
+    return changed ? 1 : 0;
+}
@@ -0,0 +1,8 @@
+#ifndef DIFF
+#define DIFF
+
+// Parses both files and prints the structural differences between them.
+// Returns 0 if the files are the same, 1 if they differ and 2 if either could not be parsed.
+int diffFiles(const char *oldPath, const char *newPath);
+
+#endif
@@ -0,0 +1,397 @@
+// ****************************************************************
+// * Columnar export of a corpus of files. Every column is a raw  *
+// * little endian array in its own file so it can be mmap-ed and *
+// * loaded without any copying or parsing.                       *
+// *                                                              *
+// * Fixed width columns:  <table>.<column>.col                   *
+// * String columns:       <table>.<column>.offsets (u64, rows+1) *
+// *                       <table>.<column>.data    (raw bytes)   *
+// * Child tables (sections, imports) refer to their file with    *
+// * fileId, files refer to their children with sectionsOffset,   *
+// * importsOffset and the section and import counts.             *
+// ****************************************************************
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "export.h"
+#include "fields.h"
+#include "parser.h"
+
+// Number of files each thread collects before flushing its columns to disk
+const uint64_t rowGroupSize = 1024;
+
+struct ColumnSchema {
+    std::string name;
+    FieldType type;
+};
+
+// Values of a single column for the rows of the current row group
+struct ColumnBuilder {
+    FieldType type;
+    std::string values; // Fixed width values or the bytes of all strings
+    std::vector<uint64_t> offsets; // End of each string in values, only for string columns
+
+    ColumnBuilder(FieldType type) {
+        this->type = type;
+    }
+
+    // Keeps the low type bytes of value, the file format is little endian like the PE format
+    void append(uint64_t value) {
+        values.append((const char *)&value, type);
+    }
+
+    void append(const char *string, size_t len) {
+        values.append(string, len);
+        offsets.push_back(values.size());
+    }
+
+    // Turns row group relative indexes into corpus wide ones, only used on u64 columns
+    void rebase(uint64_t base) {
+        for (size_t i = 0; i < values.size(); i += sizeof(uint64_t)) {
+            uint64_t value;
+            memcpy(&value, &values[i], sizeof(value));
+            value += base;
+            memcpy(&values[i], &value, sizeof(value));
+        }
+    }
+
+    void clear() {
+        values.clear();
+        offsets.clear();
+    }
+};
+
+struct TableBuilder {
+    std::vector<ColumnBuilder> columns;
+    uint64_t rows = 0;
+
+    TableBuilder(const std::vector<ColumnSchema> &schema) {
+        for (const ColumnSchema &column : schema) {
+            columns.emplace_back(column.type);
+        }
+    }
+
+    void clear() {
+        for (ColumnBuilder &column : columns) {
+            column.clear();
+        }
+        rows = 0;
+    }
+};
+
+// Built on first use since headerFields lives in another translation unit
+static const std::vector<ColumnSchema> &getFilesSchema() {
+    static const std::vector<ColumnSchema> schema = [] {
+        std::vector<ColumnSchema> columns = {{"path", FIELD_STRING}};
+        for (const HeaderField &field : headerFields) {
+            columns.push_back({field.name, field.type});
+        }
+        // First CodeView record of the debug directory, empty strings and 0 if there is none
+        columns.push_back({"pdbGuid", FIELD_STRING});
+        columns.push_back({"pdbAge", FIELD_U32});
+        columns.push_back({"pdbPath", FIELD_STRING});
+        columns.push_back({"numOfImportDlls", FIELD_U32});
+        columns.push_back({"numOfImportFunctions", FIELD_U32});
+        columns.push_back({"sectionsOffset", FIELD_U64});
+        columns.push_back({"importsOffset", FIELD_U64});
+        return columns;
+    }();
+    return schema;
+}
+
+// The last two columns of the files table
+static size_t getSectionsOffsetColumn() {
+    return getFilesSchema().size() - 2;
+}
+
+static size_t getImportsOffsetColumn() {
+    return getFilesSchema().size() - 1;
+}
+
+static const std::vector<ColumnSchema> sectionsSchema = {
+    {"fileId", FIELD_U64},
+    {"name", FIELD_STRING},
+    {"virtualSize", FIELD_U32},
+    {"virtualAddress", FIELD_U32},
+    {"sizeOfRawData", FIELD_U32},
+    {"pToRawData", FIELD_U32},
+    {"pToRelocations", FIELD_U32},
+    {"pToLinenumbers", FIELD_U32},
+    {"numOfRelocations", FIELD_U16},
+    {"numOfLinenumbers", FIELD_U16},
+    {"characteristics", FIELD_U32}
+};
+
+static const std::vector<ColumnSchema> importsSchema = {
+    {"fileId", FIELD_U64},
+    {"dll", FIELD_STRING},
+    {"name", FIELD_STRING},
+    {"hint", FIELD_U16},
+    {"isOrdinalImport", FIELD_U8}
+};
+
+// The fileId column of both child tables
+const size_t fileIdColumn = 0;
+
+// Per thread builders for all three tables, row indexes are relative to the row group
+struct RowGroupBuilder {
+    TableBuilder files{getFilesSchema()};
+    TableBuilder sections{sectionsSchema};
+    TableBuilder imports{importsSchema};
+
+    void addFile(const std::string &path, Parser *parser) {
+        uint64_t fileId = files.rows;
+        std::vector<ColumnBuilder> &f = files.columns;
+        size_t c = 0;
+        f[c++].append(path.data(), path.size());
+        for (const HeaderField &field : headerFields) {
+            f[c++].append(field.get(parser));
+        }
+
+        std::vector<CodeViewInfo> &codeView = parser->getCodeView();
+        if (codeView.empty()) {
+            f[c++].append("", 0);
+            f[c++].append(0);
+            f[c++].append("", 0);
+        } else {
+            // NB10 records have no GUID, their signature is a timestamp instead
+            std::string guid = codeView[0].cvSignature == 0x53445352 ? formatGUID(codeView[0].guid) : "";
+            f[c++].append(guid.data(), guid.size());
+            f[c++].append(codeView[0].age);
+            f[c++].append(codeView[0].pdbPath.data(), codeView[0].pdbPath.size());
+        }
+
+        std::map<DllNameFunctionNumber, std::vector<HintTableEntry>> &fileImports = parser->getImports();
+        uint64_t numOfFunctions = 0;
+        for (std::map<DllNameFunctionNumber, std::vector<HintTableEntry>>::iterator it = fileImports.begin(); it != fileImports.end(); it++) {
+            numOfFunctions += it->second.size();
+        }
+        f[c++].append(fileImports.size());
+        f[c++].append(numOfFunctions);
+        f[c++].append(sections.rows);
+        f[c++].append(imports.rows);
+        files.rows++;
+
+        for (SectionTableEntry &section : parser->getSectionTable()) {
+            std::vector<ColumnBuilder> &s = sections.columns;
+            c = 0;
+            s[c++].append(fileId);
+            s[c++].append((const char *)section.name, strnlen((const char *)section.name, sizeof(section.name)));
+            s[c++].append(section.virtualSize);
+            s[c++].append(section.virtualAddress);
+            s[c++].append(section.sizeOfRawData);
+            s[c++].append(section.pToRawData);
+            s[c++].append(section.pToRelocations);
+            s[c++].append(section.pToLinenumbers);
+            s[c++].append(section.numOfRelocations);
+            s[c++].append(section.numOfLinenumbers);
+            s[c++].append(section.characteristics);
+            sections.rows++;
+        }
+
+        for (std::map<DllNameFunctionNumber, std::vector<HintTableEntry>>::iterator it = fileImports.begin(); it != fileImports.end(); it++) {
+            for (HintTableEntry &function : it->second) {
+                std::vector<ColumnBuilder> &i = imports.columns;
+                // readAscii keeps the terminating null byte, it is not exported
+                size_t nameLen = strnlen(function.name.c_str(), function.name.size());
+                size_t dllLen = strnlen(it->first.name.c_str(), it->first.name.size());
+                c = 0;
+                i[c++].append(fileId);
+                i[c++].append(it->first.name.c_str(), dllLen);
+                i[c++].append(function.isOrdinalImport ? "" : function.name.c_str(), function.isOrdinalImport ? 0 : nameLen);
+                i[c++].append(function.hint);
+                i[c++].append(function.isOrdinalImport);
+                imports.rows++;
+            }
+        }
+    }
+
+    void clear() {
+        files.clear();
+        sections.clear();
+        imports.clear();
+    }
+};
+
+// Appends row groups of one table to its column files
+class TableWriter {
+    std::string name;
+    const std::vector<ColumnSchema> &schema;
+    std::vector<std::unique_ptr<std::ofstream>> values;
+    std::vector<std::unique_ptr<std::ofstream>> offsets;
+    std::vector<uint64_t> dataSizes;
+
+public:
+    uint64_t rows = 0;
+
+    TableWriter(const std::string &name, const std::vector<ColumnSchema> &schema) : name(name), schema(schema) {}
+
+    bool open(const std::string &directory) {
+        for (const ColumnSchema &column : schema) {
+            std::string base = directory + "/" + name + "." + column.name;
+            if (column.type == FIELD_STRING) {
+                values.push_back(std::make_unique<std::ofstream>(base + ".data", std::ios::out | std::ios::binary | std::ios::trunc));
+                offsets.push_back(std::make_unique<std::ofstream>(base + ".offsets", std::ios::out | std::ios::binary | std::ios::trunc));
+                // Offsets start with a 0 so string i is always data[offsets[i], offsets[i + 1])
+                uint64_t start = 0;
+                offsets.back()->write((const char *)&start, sizeof(start));
+                if (!*offsets.back()) {
+                    return false;
+                }
+            } else {
+                values.push_back(std::make_unique<std::ofstream>(base + ".col", std::ios::out | std::ios::binary | std::ios::trunc));
+                offsets.push_back(nullptr);
+            }
+            if (!*values.back()) {
+                return false;
+            }
+            dataSizes.push_back(0);
+        }
+        return true;
+    }
+
+    void write(TableBuilder &builder) {
+        for (size_t i = 0; i < builder.columns.size(); i++) {
+            ColumnBuilder &column = builder.columns[i];
+            values[i]->write(column.values.data(), column.values.size());
+            if (offsets[i]) {
+                for (uint64_t &offset : column.offsets) {
+                    offset += dataSizes[i];
+                }
+                offsets[i]->write((const char *)column.offsets.data(), column.offsets.size() * sizeof(uint64_t));
+                dataSizes[i] += column.values.size();
+            }
+        }
+        rows += builder.rows;
+    }
+
+    // Returns false if any of the column files could not be written
+    bool close() {
+        bool ok = true;
+        for (size_t i = 0; i < values.size(); i++) {
+            values[i]->close();
+            ok = ok && !values[i]->fail();
+            if (offsets[i]) {
+                offsets[i]->close();
+                ok = ok && !offsets[i]->fail();
+            }
+        }
+        return ok;
+    }
+
+    void writeSchema(std::ostream &out) {
+        for (const ColumnSchema &column : schema) {
+            out << name << "\t" << column.name << "\t" << getFieldTypeName(column.type) << "\t" << rows << "\n";
+        }
+    }
+};
+
+// Shared by all threads, row groups are appended whole so the tables always line up
+class CorpusWriter {
+    std::mutex lock;
+
+public:
+    TableWriter files{"files", getFilesSchema()};
+    TableWriter sections{"sections", sectionsSchema};
+    TableWriter imports{"imports", importsSchema};
+
+    bool open(const std::string &directory) {
+        return files.open(directory) && sections.open(directory) && imports.open(directory);
+    }
+
+    void flush(RowGroupBuilder &builder) {
+        if (builder.files.rows == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        builder.files.columns[getSectionsOffsetColumn()].rebase(sections.rows);
+        builder.files.columns[getImportsOffsetColumn()].rebase(imports.rows);
+        builder.sections.columns[fileIdColumn].rebase(files.rows);
+        builder.imports.columns[fileIdColumn].rebase(files.rows);
+        files.write(builder.files);
+        sections.write(builder.sections);
+        imports.write(builder.imports);
+        builder.clear();
+    }
+
+    bool close() {
+        bool ok = files.close();
+        ok = sections.close() && ok;
+        return imports.close() && ok;
+    }
+};
+
+static void exportWorker(const std::vector<std::string> *paths, std::atomic<size_t> *next, CorpusWriter *writer) {
+    RowGroupBuilder builder;
+    size_t i;
+    while ((i = (*next)++) < paths->size()) {
+        const std::string &path = (*paths)[i];
+        std::ifstream infile;
+        infile.open(path, std::ios::in | std::ios::binary);
+        if (!infile) {
+            std::cerr << "Error reading file " << path << std::endl;
+            continue;
+        }
+        try {
+            Parser parser(&infile);
+            builder.addFile(path, &parser);
+        } catch (const std::exception &e) {
+            std::cerr << "Skipping " << path << ": " << e.what() << std::endl;
+            continue;
+        }
+        if (builder.files.rows >= rowGroupSize) {
+            writer->flush(builder);
+        }
+    }
+    writer->flush(builder);
+}
+
+int exportCorpus(const char *outputDirectory, const std::vector<std::string> &paths) {
+    std::string directory = outputDirectory;
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cerr << "Could not create directory " << directory << std::endl;
+        return 1;
+    }
+
+    CorpusWriter writer;
+    if (!writer.open(directory)) {
+        std::cerr << "Could not create column files in " << directory << std::endl;
+        return 1;
+    }
+
+    std::atomic<size_t> next(0);
+    unsigned int numOfWorkers = std::max(1u, std::min<unsigned int>(std::thread::hardware_concurrency(), paths.size()));
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < numOfWorkers; i++) {
+        workers.emplace_back(exportWorker, &paths, &next, &writer);
+    }
+    for (std::thread &t : workers) {
+        t.join();
+    }
+
+    std::ofstream schema(directory + "/schema.txt", std::ios::out | std::ios::trunc);
+    schema << "# table\tcolumn\ttype\trows\n";
+    writer.files.writeSchema(schema);
+    writer.sections.writeSchema(schema);
+    writer.imports.writeSchema(schema);
+    schema.close();
+
+    if (!writer.close() || schema.fail()) {
+        std::cerr << "Error writing column files in " << directory << std::endl;
+        return 1;
+    }
+    std::cout << std::dec << "Exported " << writer.files.rows << " file(s), " << writer.sections.rows << " section(s), " << writer.imports.rows << " import(s)\n";
+    return 0;
+}
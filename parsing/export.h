@@ -0,0 +1,11 @@
+#ifndef EXPORT
+#define EXPORT
+
+#include <string>
+#include <vector>
+
+// Parses every file and writes the header, section and import fields as raw column files
+// into outputDirectory. The layout is described in the schema.txt file written alongside.
+int exportCorpus(const char *outputDirectory, const std::vector<std::string> &paths);
+
+#endif
@@ -0,0 +1,69 @@
+// ****************************************************************
+// * Flat list of header fields so that every header can be       *
+// * walked generically, e.g. for exporting or comparing files    *
+// ****************************************************************
+
+#include "fields.h"
+
+#define COFF_FIELD(field, type) {#field, type, [](Parser *parser) -> uint64_t { return parser->getCOFFHeader()->field; }}
+
+#define STANDARD_FIELD(field, type) {#field, type, [](Parser *parser) -> uint64_t { \
+    return parser->is64bit() ? parser->getOptionalHeader64()->standardHead.field : parser->getOptionalHeader32()->standardHead.field; }}
+
+#define WINDOWS_FIELD(field, type) {#field, type, [](Parser *parser) -> uint64_t { \
+    return parser->is64bit() ? parser->getOptionalHeader64()->winHead.field : parser->getOptionalHeader32()->winHead.field; }}
+
+const char *getFieldTypeName(FieldType type) {
+    switch (type) {
+        case FIELD_U8: return "u8";
+        case FIELD_U16: return "u16";
+        case FIELD_U32: return "u32";
+        case FIELD_U64: return "u64";
+        default: return "string";
+    }
+}
+
+const std::vector<HeaderField> headerFields = {
+    {"is64bit", FIELD_U8, [](Parser *parser) -> uint64_t { return parser->is64bit(); }},
+
+    COFF_FIELD(machine, FIELD_U16),
+    COFF_FIELD(numOfSections, FIELD_U16),
+    COFF_FIELD(timeDateStamp, FIELD_U32),
+    COFF_FIELD(pToSymbolTable, FIELD_U32),
+    COFF_FIELD(numOfSymbols, FIELD_U32),
+    COFF_FIELD(sizeOfOptionalHeader, FIELD_U16),
+    COFF_FIELD(characteristics, FIELD_U16),
+
+    STANDARD_FIELD(magic, FIELD_U16),
+    STANDARD_FIELD(majorLinkerVersion, FIELD_U8),
+    STANDARD_FIELD(minorLinkerVersion, FIELD_U8),
+    STANDARD_FIELD(sizeOfCode, FIELD_U32),
+    STANDARD_FIELD(sizeOfInitializedData, FIELD_U32),
+    STANDARD_FIELD(sizeOfUnitializedData, FIELD_U32),
+    STANDARD_FIELD(addressOfEntryPoint, FIELD_U32),
+    STANDARD_FIELD(baseOfCode, FIELD_U32),
+    // Only present in PE32 files, always 0 for PE32+
+    {"baseOfData", FIELD_U32, [](Parser *parser) -> uint64_t { return parser->is64bit() ? 0 : parser->getOptionalHeader32()->standardHead.baseOfData; }},
+
+    WINDOWS_FIELD(imageBase, FIELD_U64),
+    WINDOWS_FIELD(sectionAlignment, FIELD_U32),
+    WINDOWS_FIELD(fileAlignment, FIELD_U32),
+    WINDOWS_FIELD(majorOSVersion, FIELD_U16),
+    WINDOWS_FIELD(minorOSVersion, FIELD_U16),
+    WINDOWS_FIELD(majorImageVersion, FIELD_U16),
+    WINDOWS_FIELD(minorImageVersion, FIELD_U16),
+    WINDOWS_FIELD(majorSubsysVersion, FIELD_U16),
+    WINDOWS_FIELD(minotSubsysVersion, FIELD_U16),
+    WINDOWS_FIELD(win32VersionValue, FIELD_U32),
+    WINDOWS_FIELD(sizeOfImage, FIELD_U32),
+    WINDOWS_FIELD(sizeOfHeaders, FIELD_U32),
+    WINDOWS_FIELD(checkSum, FIELD_U32),
+    WINDOWS_FIELD(subsystem, FIELD_U16),
+    WINDOWS_FIELD(dllCharacteristics, FIELD_U16),
+    WINDOWS_FIELD(sizeOfStackReserve, FIELD_U64),
+    WINDOWS_FIELD(sizeOfStackCommit, FIELD_U64),
+    WINDOWS_FIELD(sizeOfHeapReserve, FIELD_U64),
+    WINDOWS_FIELD(sizeOfHeapCommit, FIELD_U64),
+    WINDOWS_FIELD(loaderFlags, FIELD_U32),
+    WINDOWS_FIELD(numOfRvaAndSizes, FIELD_U32)
+};
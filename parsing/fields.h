@@ -0,0 +1,30 @@
+#ifndef FIELDS
+#define FIELDS
+
+#include <cstdint>
+#include <vector>
+
+#include "parser.h"
+
+// Type of a single exported value, the value of each type is its width in bytes
+enum FieldType {
+    FIELD_STRING = 0,
+    FIELD_U8 = 1,
+    FIELD_U16 = 2,
+    FIELD_U32 = 4,
+    FIELD_U64 = 8
+};
+
+const char *getFieldTypeName(FieldType type);
+
+// A single header field, PE32 and PE32+ values are both widened to uint64_t
+struct HeaderField {
+    const char *name;
+    FieldType type;
+    uint64_t (*get)(Parser *parser);
+};
+
+// Every field of the COFF, standard and windows headers in file order
+extern const std::vector<HeaderField> headerFields;
+
+#endif
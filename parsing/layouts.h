@@ -0,0 +1,245 @@
+#ifndef LAYOUTS
+#define LAYOUTS
+
+// ****************************************************************
+// * Field layouts of the data directory structures that changed  *
+// * size over the Windows releases. Each table is sorted by      *
+// * offset, a newer version of a structure only appends fields,  *
+// * so the fields present in a file are the ones that fit in     *
+// * the size the structure declares. Supporting a new version    *
+// * means adding rows here.                                      *
+// ****************************************************************
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "../utils/pe-lab-lib.h"
+
+// Location of one field inside a structure
+struct LayoutField {
+    const char *name;
+    uint16_t offset;
+    uint8_t width; // 2, 4 or 8 bytes
+};
+
+struct Layout {
+    const LayoutField *fields;
+    size_t numOfFields;
+};
+
+constexpr LayoutField tlsLayout32[] = {
+    {"StartAddressOfRawData", 0, 4},
+    {"EndAddressOfRawData", 4, 4},
+    {"AddressOfIndex", 8, 4},
+    {"AddressOfCallBacks", 12, 4},
+    {"SizeOfZeroFill", 16, 4},
+    {"Characteristics", 20, 4}
+};
+
+constexpr LayoutField tlsLayout64[] = {
+    {"StartAddressOfRawData", 0, 8},
+    {"EndAddressOfRawData", 8, 8},
+    {"AddressOfIndex", 16, 8},
+    {"AddressOfCallBacks", 24, 8},
+    {"SizeOfZeroFill", 32, 4},
+    {"Characteristics", 36, 4}
+};
+
+constexpr LayoutField loadConfigLayout32[] = {
+    {"Size", 0, 4},
+    {"TimeDateStamp", 4, 4},
+    {"MajorVersion", 8, 2},
+    {"MinorVersion", 10, 2},
+    {"GlobalFlagsClear", 12, 4},
+    {"GlobalFlagsSet", 16, 4},
+    {"CriticalSectionDefaultTimeout", 20, 4},
+    {"DeCommitFreeBlockThreshold", 24, 4},
+    {"DeCommitTotalFreeThreshold", 28, 4},
+    {"LockPrefixTable", 32, 4},
+    {"MaximumAllocationSize", 36, 4},
+    {"VirtualMemoryThreshold", 40, 4},
+    {"ProcessHeapFlags", 44, 4},
+    {"ProcessAffinityMask", 48, 4},
+    {"CSDVersion", 52, 2},
+    {"DependentLoadFlags", 54, 2},
+    {"EditList", 56, 4},
+    {"SecurityCookie", 60, 4},
+    // Windows 2000 ends here, Size 0x40
+    {"SEHandlerTable", 64, 4},
+    {"SEHandlerCount", 68, 4},
+    // Windows XP SP2 and Server 2003 end here, Size 0x48
+    {"GuardCFCheckFunctionPointer", 72, 4},
+    {"GuardCFDispatchFunctionPointer", 76, 4},
+    {"GuardCFFunctionTable", 80, 4},
+    {"GuardCFFunctionCount", 84, 4},
+    {"GuardFlags", 88, 4},
+    // Windows 8.1 ends here, Size 0x5C. Windows 10 and 11 releases keep appending from here on
+    {"CodeIntegrityFlags", 92, 2},
+    {"CodeIntegrityCatalog", 94, 2},
+    {"CodeIntegrityCatalogOffset", 96, 4},
+    {"CodeIntegrityReserved", 100, 4},
+    {"GuardAddressTakenIatEntryTable", 104, 4},
+    {"GuardAddressTakenIatEntryCount", 108, 4},
+    {"GuardLongJumpTargetTable", 112, 4},
+    {"GuardLongJumpTargetCount", 116, 4},
+    {"DynamicValueRelocTable", 120, 4},
+    {"CHPEMetadataPointer", 124, 4},
+    {"GuardRFFailureRoutine", 128, 4},
+    {"GuardRFFailureRoutineFunctionPointer", 132, 4},
+    {"DynamicValueRelocTableOffset", 136, 4},
+    {"DynamicValueRelocTableSection", 140, 2},
+    {"Reserved2", 142, 2},
+    {"GuardRFVerifyStackPointerFunctionPointer", 144, 4},
+    {"HotPatchTableOffset", 148, 4},
+    {"Reserved3", 152, 4},
+    {"EnclaveConfigurationPointer", 156, 4},
+    {"VolatileMetadataPointer", 160, 4},
+    {"GuardEHContinuationTable", 164, 4},
+    {"GuardEHContinuationCount", 168, 4},
+    {"GuardXFGCheckFunctionPointer", 172, 4},
+    {"GuardXFGDispatchFunctionPointer", 176, 4},
+    {"GuardXFGTableDispatchFunctionPointer", 180, 4},
+    {"CastGuardOsDeterminedFailureMode", 184, 4},
+    {"GuardMemcpyFunctionPointer", 188, 4}
+};
+
+constexpr LayoutField loadConfigLayout64[] = {
+    {"Size", 0, 4},
+    {"TimeDateStamp", 4, 4},
+    {"MajorVersion", 8, 2},
+    {"MinorVersion", 10, 2},
+    {"GlobalFlagsClear", 12, 4},
+    {"GlobalFlagsSet", 16, 4},
+    {"CriticalSectionDefaultTimeout", 20, 4},
+    {"DeCommitFreeBlockThreshold", 24, 8},
+    {"DeCommitTotalFreeThreshold", 32, 8},
+    {"LockPrefixTable", 40, 8},
+    {"MaximumAllocationSize", 48, 8},
+    {"VirtualMemoryThreshold", 56, 8},
+    {"ProcessAffinityMask", 64, 8},
+    {"ProcessHeapFlags", 72, 4},
+    {"CSDVersion", 76, 2},
+    {"DependentLoadFlags", 78, 2},
+    {"EditList", 80, 8},
+    {"SecurityCookie", 88, 8},
+    // Windows 2000 ends here, Size 0x60
+    {"SEHandlerTable", 96, 8},
+    {"SEHandlerCount", 104, 8},
+    // Windows XP SP2 and Server 2003 end here, Size 0x70
+    {"GuardCFCheckFunctionPointer", 112, 8},
+    {"GuardCFDispatchFunctionPointer", 120, 8},
+    {"GuardCFFunctionTable", 128, 8},
+    {"GuardCFFunctionCount", 136, 8},
+    {"GuardFlags", 144, 4},
+    // Windows 8.1 ends here, Size 0x94. Windows 10 and 11 releases keep appending from here on
+    {"CodeIntegrityFlags", 148, 2},
+    {"CodeIntegrityCatalog", 150, 2},
+    {"CodeIntegrityCatalogOffset", 152, 4},
+    {"CodeIntegrityReserved", 156, 4},
+    {"GuardAddressTakenIatEntryTable", 160, 8},
+    {"GuardAddressTakenIatEntryCount", 168, 8},
+    {"GuardLongJumpTargetTable", 176, 8},
+    {"GuardLongJumpTargetCount", 184, 8},
+    {"DynamicValueRelocTable", 192, 8},
+    {"CHPEMetadataPointer", 200, 8},
+    {"GuardRFFailureRoutine", 208, 8},
+    {"GuardRFFailureRoutineFunctionPointer", 216, 8},
+    {"DynamicValueRelocTableOffset", 224, 4},
+    {"DynamicValueRelocTableSection", 228, 2},
+    {"Reserved2", 230, 2},
+    {"GuardRFVerifyStackPointerFunctionPointer", 232, 8},
+    {"HotPatchTableOffset", 240, 4},
+    {"Reserved3", 244, 4},
+    {"EnclaveConfigurationPointer", 248, 8},
+    {"VolatileMetadataPointer", 256, 8},
+    {"GuardEHContinuationTable", 264, 8},
+    {"GuardEHContinuationCount", 272, 8},
+    {"GuardXFGCheckFunctionPointer", 280, 8},
+    {"GuardXFGDispatchFunctionPointer", 288, 8},
+    {"GuardXFGTableDispatchFunctionPointer", 296, 8},
+    {"CastGuardOsDeterminedFailureMode", 304, 8},
+    {"GuardMemcpyFunctionPointer", 312, 8}
+};
+
+template <size_t N>
+constexpr Layout makeLayout(const LayoutField (&fields)[N]) {
+    return {fields, N};
+}
+
+constexpr Layout tlsLayout(bool is64bit) {
+    return is64bit ? makeLayout(tlsLayout64) : makeLayout(tlsLayout32);
+}
+
+constexpr Layout loadConfigLayout(bool is64bit) {
+    return is64bit ? makeLayout(loadConfigLayout64) : makeLayout(loadConfigLayout32);
+}
+
+// Size of the structure with every known field present
+constexpr size_t getLayoutSize(Layout layout) {
+    return layout.fields[layout.numOfFields - 1].offset + layout.fields[layout.numOfFields - 1].width;
+}
+
+// Fields have to be sorted and must not overlap, otherwise fields present in a
+// structure would not be a prefix of its table
+constexpr bool isValidLayout(Layout layout) {
+    for (size_t i = 1; i < layout.numOfFields; i++) {
+        if (layout.fields[i].offset < layout.fields[i - 1].offset + layout.fields[i - 1].width) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr bool namesEqual(const char *a, const char *b) {
+    while (*a != 0 && *a == *b) {
+        a++;
+        b++;
+    }
+    return *a == *b;
+}
+
+// Index of a field in the table, numOfFields if there is no such field
+constexpr size_t findLayoutField(Layout layout, const char *name) {
+    for (size_t i = 0; i < layout.numOfFields; i++) {
+        if (namesEqual(layout.fields[i].name, name)) {
+            return i;
+        }
+    }
+    return layout.numOfFields;
+}
+
+// End of a field, ie. the Size of a structure version whose last field it is
+constexpr size_t getFieldEnd(Layout layout, const char *name) {
+    return layout.fields[findLayoutField(layout, name)].offset + layout.fields[findLayoutField(layout, name)].width;
+}
+
+static_assert(isValidLayout(tlsLayout(false)) && isValidLayout(tlsLayout(true)), "TLS layouts must be sorted");
+static_assert(isValidLayout(loadConfigLayout(false)) && isValidLayout(loadConfigLayout(true)), "Load config layouts must be sorted");
+static_assert(getLayoutSize(tlsLayout(false)) == 24 && getLayoutSize(tlsLayout(true)) == 40, "Unexpected TLS directory size");
+static_assert(getLayoutSize(loadConfigLayout(false)) == 192 && getLayoutSize(loadConfigLayout(true)) == 320, "Unexpected load config size");
+
+static_assert(getFieldEnd(loadConfigLayout(false), "SecurityCookie") == 0x40 && getFieldEnd(loadConfigLayout(false), "SEHandlerCount") == 0x48
+    && getFieldEnd(loadConfigLayout(false), "GuardFlags") == 0x5C, "Load config version markers out of date");
+static_assert(getFieldEnd(loadConfigLayout(true), "SecurityCookie") == 0x60 && getFieldEnd(loadConfigLayout(true), "SEHandlerCount") == 0x70
+    && getFieldEnd(loadConfigLayout(true), "GuardFlags") == 0x94, "Load config version markers out of date");
+
+// Fields looked up by the parser, both flavors share the same index
+constexpr size_t tlsCallbacksField = findLayoutField(tlsLayout(false), "AddressOfCallBacks");
+constexpr size_t guardFlagsField = findLayoutField(loadConfigLayout(false), "GuardFlags");
+static_assert(tlsCallbacksField == findLayoutField(tlsLayout(true), "AddressOfCallBacks"), "Layouts out of sync");
+static_assert(guardFlagsField == findLayoutField(loadConfigLayout(true), "GuardFlags"), "Layouts out of sync");
+
+// Decodes every field of the layout that fits into the first size bytes of data
+inline std::vector<DirectoryField> decodeLayout(Layout layout, const char *data, size_t size) {
+    std::vector<DirectoryField> fields;
+    for (size_t i = 0; i < layout.numOfFields && layout.fields[i].offset + layout.fields[i].width <= size; i++) {
+        uint64_t value = 0;
+        memcpy(&value, data + layout.fields[i].offset, layout.fields[i].width);
+        fields.push_back({layout.fields[i].name, value, layout.fields[i].width});
+    }
+    return fields;
+}
+
+#endif
@@ -0,0 +1,578 @@
+#ifndef PARSER
+#define PARSER
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iomanip>
+#include <ios>
+#include <iostream>
+#include <fstream>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "../utils/pe-lab-lib.h"
+#include "../utils/utils.h"
+#include "../utils/logging.h"
+#include "layouts.h"
+#include "symbols.h"
+
+class Parser {
+    // Used for storing offsets to varius important parts of file which makes parsing easier
+    struct ParsingInfo {
+        uint32_t peOffset;
+        uint32_t COFFOffset;
+        uint32_t OptionalHeaderOffset;
+        uint32_t DataDirectoryOffset;
+        uint32_t SectiontableOffset;
+        bool is64bit;
+        uint32_t numOfRVAandSizes;
+        uint16_t numOfSections;
+    };
+   
+    // Structures needed for parsing the file, explained in the pe-lab-lib.h file
+    std::ifstream *infile;
+    std::unique_ptr<ParsingInfo> parsingInfo = std::make_unique<ParsingInfo>(); 
+    std::unique_ptr<COFFHeader> coffHeader = std::make_unique<COFFHeader>();
+    std::unique_ptr<PE32OptionalHeader> optionalHeader32bit = std::make_unique<PE32OptionalHeader>();
+    std::unique_ptr<PE32PlusOptionalHeader> optionalHeader64bit = std::make_unique<PE32PlusOptionalHeader>();
+    std::vector<ImageDataDirectoryEntry> dataDirectoryTable;
+    std::vector<SectionTableEntry> sectionTable;
+    std::vector<ImportDirectoryTableEntry> IDT;
+    std::map<DllNameFunctionNumber, std::vector<HintTableEntry>> imports;
+    SymbolTable symbolTable;
+    std::vector<DebugDirectoryEntry> debugDirectory;
+    std::vector<CodeViewInfo> codeView;
+    std::vector<PogoEntry> pogoEntries;
+    std::vector<uint8_t> reproHash;
+    std::vector<DirectoryField> tlsDirectory;
+    std::vector<uint64_t> tlsCallbacks;
+    std::vector<DirectoryField> loadConfig;
+
+    // Seeks inside PE file currently pointed to by infile
+    void seek(uint32_t offset) {
+        infile->seekg(offset, std::ios::beg);
+    }
+
+    bool verifySignature() {
+        char *pe = new char[4];
+        seek(parsingInfo->peOffset);
+        infile->read(pe, 4);
+        if (!(pe[0] == 'P' && pe[1] == 'E' && pe[2] == '\0' && pe[3] == '\0')) {
+            return 0;
+        }
+        delete [] pe;
+        return 1; 
+    }
+
+    void parseCOFF(uint32_t offset) {
+        seek(offset);
+        infile->read((char *)&(*coffHeader), sizeof(COFFHeader));
+    }
+
+    void parseOptionalHeader(uint32_t offset) {
+        seek(offset);
+        if (parsingInfo->is64bit) {
+            infile->read((char *)&*optionalHeader64bit,sizeof(PE32PlusOptionalHeader));
+        } else {
+            infile->read((char *)&*optionalHeader32bit, sizeof(PE32OptionalHeader));
+        }
+    }
+
+    // numOfRvaAndSizes comes straight from the file, so like the loader only trust as many
+    // entries as there are defined directories and as fit in sizeOfOptionalHeader
+    uint32_t getNumOfDataDirectories(uint32_t numOfRvaAndSizes) {
+        const uint32_t maxDataDirectories = 16;
+        uint32_t fixedSize = parsingInfo->is64bit ? sizeof(PE32PlusOptionalHeader) : sizeof(PE32OptionalHeader);
+        uint32_t fitting = coffHeader->sizeOfOptionalHeader > fixedSize ? (coffHeader->sizeOfOptionalHeader - fixedSize) / sizeof(ImageDataDirectoryEntry) : 0;
+        return std::min({numOfRvaAndSizes, fitting, maxDataDirectories});
+    }
+
+    void parseDataDirectories(uint32_t size, int offset) {
+        if (size != 0) {
+            ImageDataDirectoryEntry idDir;
+            for (unsigned int i = 0; i < size; i++) {
+                seek(offset + i * sizeof(ImageDataDirectoryEntry));
+                infile->read((char *)&idDir, sizeof(idDir));
+                dataDirectoryTable.push_back(idDir);
+            }
+        }
+    }
+
+    void parseSectionTable(int numOfSections, int offset) {
+        SectionTableEntry e;
+        for (int i = 0; i < numOfSections; i++) {
+            seek(offset + i * sizeof(SectionTableEntry));
+            infile->read((char *)&e, sizeof(e));
+            sectionTable.push_back(e);
+        }
+    }
+
+    SectionTableEntry locateImportTable(ImageDataDirectoryEntry importDir, std::vector<SectionTableEntry> sections) {
+        SectionTableEntry importSection = {};
+        for (SectionTableEntry section : sections) {
+            if (importDir.VA >= section.virtualAddress && importDir.VA < section.virtualAddress + section.virtualSize) {
+                 importSection = section;
+            }
+        }
+
+        return importSection;
+    }
+
+
+    std::vector<HintTableEntry> getHintTableEntries(int ILT_offset, SectionTableEntry importSection, ImportDirectoryTableEntry idt_entry, int *functionNum) {
+        int i = 1;
+        std::vector<HintTableEntry> hintTable;
+        if (parsingInfo->is64bit) {
+            ILTEntryPE32Plus entry;
+            seek(ILT_offset);
+            infile->read((char *)&entry, sizeof(ILTEntryPE32Plus));
+            while (entry.bitField != 0 && infile->good()) {
+                if (entry.bitField & 0x8000000000000000) {
+                    uint16_t hint = entry.bitField & 0x7FFFFFFFFFFFFFFF;
+                    std::string importName = "0"; 
+                    HintTableEntry h_entry(hint, importName, true);
+                    hintTable.push_back(h_entry);
+                } else {
+                    uint16_t hint;
+                    seek(importSection.pToRawData + (entry.bitField - importSection.virtualAddress));
+                    infile->read((char *)&hint, sizeof(hint));
+                    std::string importName = readAscii(infile, importSection.pToRawData + (entry.bitField + 2 - importSection.virtualAddress)); 
+                    HintTableEntry h_entry(hint, importName, false);
+                    hintTable.push_back(h_entry);
+                }
+                seek(ILT_offset + i * sizeof(ILTEntryPE32Plus));
+                infile->read((char*)&entry, sizeof(entry));
+                i++;
+            }
+        } else {
+            ILTEntryPE32 entry;
+            seek(ILT_offset);
+            infile->read((char *)&entry, sizeof(ILTEntryPE32));
+            while (entry.bitField != 0 && infile->good()) {
+                if (entry.bitField & 0x80000000) {
+                    uint16_t hint = entry.bitField & 0x7FFFFFFF;
+                    std::string importName = "0"; 
+                    HintTableEntry h_entry(hint, importName, true);
+                    hintTable.push_back(h_entry);
+                } else {
+                    uint16_t hint;
+                    seek(importSection.pToRawData + (entry.bitField - importSection.virtualAddress));
+                    infile->read((char *)&hint, sizeof(hint));
+                    std::string importName = readAscii(infile, importSection.pToRawData + (entry.bitField + 2 - importSection.virtualAddress)); 
+                    HintTableEntry h_entry(hint, importName, false);
+                    hintTable.push_back(h_entry);
+                }
+                seek(ILT_offset + i * sizeof(ILTEntryPE32));
+                infile->read((char*)&entry, sizeof(entry));
+                i++;
+            }
+        }
+        *functionNum = i - 1;
+        return hintTable;
+    }
+
+    void parseImportTable(ImageDataDirectoryEntry importDir, std::vector<SectionTableEntry> sections) {
+        if (importDir.VA == 0) {
+            return;
+        }
+        SectionTableEntry importSection = locateImportTable(importDir, sections); 
+        ImportDirectoryTableEntry e;
+        int import_offset = importSection.pToRawData + (importDir.VA - importSection.virtualAddress);
+        seek(import_offset);
+        infile->read((char *)&e, sizeof(e));
+        int i = 1;
+        while (e.nameRVA != 0 && infile->good()) {
+            IDT.push_back(e);
+            seek(import_offset + i * sizeof(ImportDirectoryTableEntry));
+            infile->read((char *)&e, sizeof(e));
+            i++;
+        }
+
+        for (ImportDirectoryTableEntry idt_entry : IDT) {
+            int functionNum = 0;
+            int IAT_offset = importSection.pToRawData + (idt_entry.IAT_RVA - importSection.virtualAddress); 
+            std::string dllName = readAscii(infile, importSection.pToRawData + (idt_entry.nameRVA - importSection.virtualAddress));
+            std::vector<HintTableEntry> hintTable = getHintTableEntries(IAT_offset, importSection, idt_entry, &functionNum);
+            DllNameFunctionNumber temp(functionNum, dllName);
+            imports.insert({temp, hintTable});
+        }
+
+    }
+
+    // Section containing the RVA, NULL if no section does
+    SectionTableEntry *findSection(uint32_t rva) {
+        for (SectionTableEntry &section : sectionTable) {
+            if (rva >= section.virtualAddress && rva < section.virtualAddress + std::max(section.virtualSize, section.sizeOfRawData)) {
+                return &section;
+            }
+        }
+        return NULL;
+    }
+
+    // Translates an RVA to a file offset through the section containing it, returns false if no section does
+    bool rvaToOffset(uint32_t rva, uint32_t *offset) {
+        SectionTableEntry *section = findSection(rva);
+        if (section == NULL) {
+            return false;
+        }
+        *offset = section->pToRawData + (rva - section->virtualAddress);
+        return true;
+    }
+
+    uint64_t getImageBase() {
+        return parsingInfo->is64bit ? optionalHeader64bit->winHead.imageBase : optionalHeader32bit->winHead.imageBase;
+    }
+
+    void parseCodeView(const std::vector<char> &data) {
+        CodeViewInfo info;
+        size_t pathOffset;
+        memcpy(&info.cvSignature, data.data(), sizeof(info.cvSignature));
+        if (info.cvSignature == 0x53445352 && data.size() >= 24) { // RSDS
+            memcpy(info.guid, data.data() + 4, sizeof(info.guid));
+            memcpy(&info.age, data.data() + 20, sizeof(info.age));
+            info.nb10Signature = 0;
+            pathOffset = 24;
+        } else if (info.cvSignature == 0x3031424e && data.size() >= 16) { // NB10
+            memset(info.guid, 0, sizeof(info.guid));
+            memcpy(&info.nb10Signature, data.data() + 8, sizeof(info.nb10Signature));
+            memcpy(&info.age, data.data() + 12, sizeof(info.age));
+            pathOffset = 16;
+        } else {
+            return;
+        }
+        info.pdbPath = std::string(data.data() + pathOffset, strnlen(data.data() + pathOffset, data.size() - pathOffset));
+        codeView.push_back(info);
+    }
+
+    void parsePogo(const std::vector<char> &data) {
+        // Starts with a 4 byte signature, then rva, size and a null terminated name aligned to 4 bytes
+        size_t i = 4;
+        while (i + 8 < data.size()) {
+            uint32_t rva, size;
+            memcpy(&rva, data.data() + i, sizeof(rva));
+            memcpy(&size, data.data() + i + 4, sizeof(size));
+            const char *name = data.data() + i + 8;
+            size_t nameLen = strnlen(name, data.size() - i - 8);
+            pogoEntries.emplace_back(rva, size, std::string(name, nameLen));
+            i = (i + 8 + nameLen + 1 + 3) & ~(size_t)3;
+        }
+    }
+
+    void parseRepro(const std::vector<char> &data) {
+        // Length of the hash followed by the hash, no data at all if the timestamp is the hash
+        uint32_t len;
+        memcpy(&len, data.data(), sizeof(len));
+        len = std::min<size_t>(len, data.size() - 4);
+        reproHash.assign(data.begin() + 4, data.begin() + 4 + len);
+    }
+
+    // Directory entries already hold the file offset of their data, only the directory itself
+    // has to be located through the section table
+    void parseDebugDirectory(ImageDataDirectoryEntry debugDir) {
+        uint32_t offset;
+        if (debugDir.VA == 0 || debugDir.size <= 0 || !rvaToOffset(debugDir.VA, &offset)) {
+            return;
+        }
+        // Cap the number of entries, a real directory has a handful of them
+        debugDirectory.resize(std::min<size_t>(debugDir.size / sizeof(DebugDirectoryEntry), 64));
+        seek(offset);
+        infile->read((char *)debugDirectory.data(), debugDirectory.size() * sizeof(DebugDirectoryEntry));
+        debugDirectory.resize(infile->gcount() / sizeof(DebugDirectoryEntry));
+        infile->clear();
+
+        std::vector<char> data;
+        for (DebugDirectoryEntry &entry : debugDirectory) {
+            uint32_t dataOffset = entry.pToRawData;
+            if ((dataOffset == 0 && !rvaToOffset(entry.addressOfRawData, &dataOffset)) || entry.sizeOfData < 4) {
+                continue;
+            }
+            data.resize(std::min<uint32_t>(entry.sizeOfData, 1 << 20));
+            seek(dataOffset);
+            infile->read(data.data(), data.size());
+            data.resize(infile->gcount());
+            infile->clear();
+            if (data.size() < 4) {
+                continue;
+            }
+
+            switch (entry.type) {
+                case 2: parseCodeView(data); break;
+                case 13: parsePogo(data); break;
+                case 16: parseRepro(data); break;
+            }
+        }
+    }
+
+    // Reads the null terminated array of callback VAs with a single read, bounded by the end of its section
+    void parseTLSCallbacks(uint64_t callbacksVA) {
+        if (callbacksVA < getImageBase() || callbacksVA - getImageBase() > UINT32_MAX) {
+            return;
+        }
+        uint32_t rva = callbacksVA - getImageBase();
+        SectionTableEntry *section = findSection(rva);
+        if (section == NULL || rva - section->virtualAddress >= section->sizeOfRawData) {
+            return;
+        }
+        size_t pointerSize = parsingInfo->is64bit ? sizeof(uint64_t) : sizeof(uint32_t);
+        size_t maxCallbacks = std::min<size_t>((section->sizeOfRawData - (rva - section->virtualAddress)) / pointerSize, 1024);
+        std::vector<char> data(maxCallbacks * pointerSize);
+        seek(section->pToRawData + (rva - section->virtualAddress));
+        infile->read(data.data(), data.size());
+        size_t len = infile->gcount();
+        infile->clear();
+
+        for (size_t i = 0; i + pointerSize <= len; i += pointerSize) {
+            uint64_t callback = 0;
+            memcpy(&callback, data.data() + i, pointerSize);
+            if (callback == 0) {
+                break;
+            }
+            tlsCallbacks.push_back(callback);
+        }
+    }
+
+    void parseTLSDirectory(ImageDataDirectoryEntry tlsDir) {
+        uint32_t offset;
+        if (tlsDir.VA == 0 || !rvaToOffset(tlsDir.VA, &offset)) {
+            return;
+        }
+        Layout layout = tlsLayout(parsingInfo->is64bit);
+        char data[getLayoutSize(tlsLayout(true))];
+        seek(offset);
+        infile->read(data, getLayoutSize(layout));
+        size_t len = infile->gcount();
+        infile->clear();
+
+        tlsDirectory = decodeLayout(layout, data, len);
+        if (tlsDirectory.size() > tlsCallbacksField && tlsDirectory[tlsCallbacksField].value != 0) {
+            parseTLSCallbacks(tlsDirectory[tlsCallbacksField].value);
+        }
+    }
+
+    // The structure starts with its own size, which tells which version of the layout the file uses.
+    // Sizes bigger than the known layout come from newer versions, only the known fields are decoded.
+    void parseLoadConfig(ImageDataDirectoryEntry loadConfigDir) {
+        uint32_t offset;
+        if (loadConfigDir.VA == 0 || !rvaToOffset(loadConfigDir.VA, &offset)) {
+            return;
+        }
+        Layout layout = loadConfigLayout(parsingInfo->is64bit);
+        char data[getLayoutSize(loadConfigLayout(true))];
+        seek(offset);
+        infile->read(data, getLayoutSize(layout));
+        size_t len = infile->gcount();
+        infile->clear();
+
+        uint32_t declaredSize;
+        if (len < sizeof(declaredSize)) {
+            return;
+        }
+        memcpy(&declaredSize, data, sizeof(declaredSize));
+        loadConfig = decodeLayout(layout, data, std::min<size_t>(declaredSize, len));
+    }
+
+public:
+
+    // Reads the whole symbol table and the string table after it with a single read.
+    // Not part of initialParse since most images don't have one and the tables can be large.
+    bool parseSymbolTable() {
+        if (coffHeader->pToSymbolTable == 0 || coffHeader->numOfSymbols == 0) {
+            return false;
+        }
+        infile->clear();
+        infile->seekg(0, std::ios::end);
+        uint64_t fileSize = infile->tellg();
+        uint64_t symbolsEnd = coffHeader->pToSymbolTable + (uint64_t)coffHeader->numOfSymbols * symbolRecordSize;
+        if (symbolsEnd > fileSize) {
+            return false;
+        }
+
+        // The string table starts with its size, including the size field itself
+        uint32_t stringTableSize = 0;
+        seek(symbolsEnd);
+        infile->read((char *)&stringTableSize, sizeof(stringTableSize));
+        infile->clear();
+        stringTableSize = std::min<uint64_t>(stringTableSize, fileSize - symbolsEnd);
+
+        std::vector<char> data(symbolsEnd - coffHeader->pToSymbolTable + stringTableSize);
+        seek(coffHeader->pToSymbolTable);
+        if (!infile->read(data.data(), data.size())) {
+            infile->clear();
+            return false;
+        }
+        symbolTable.assign(std::move(data), coffHeader->numOfSymbols);
+        return true;
+    }
+
+    std::vector<CodeViewInfo> &getCodeView() {
+        return codeView;
+    }
+
+    void printSymbols(const SymbolFilter &filter) {
+        std::cout << std::hex << std::setfill('0');
+        printSymbolTableHeader(symbolTable.size());
+        symbolTable.forEachSymbol(filter, [](const SymbolView &view) {
+            std::string_view name = view.name;
+            // .file symbols keep the source file name in their auxiliary records
+            if (view.symbol.storageClass == storageClassFile && view.symbol.numOfAuxSymbols > 0) {
+                name = std::string_view(view.aux, strnlen(view.aux, view.symbol.numOfAuxSymbols * symbolRecordSize));
+            }
+            printSymbol(view.index, &view.symbol, name);
+        });
+    }
+
+    int initialParse() {
+        // Parse location of PE signature
+        seek(0x3c);
+        infile->read((char *)&(parsingInfo->peOffset), sizeof(parsingInfo->peOffset));
+        
+        // Parse and verify the signature
+        if (!verifySignature()) {
+            std::cerr << "Invalid PE signature. Terminating\n";
+            return 0;
+        }
+
+        // COFFHeader is right after PE signature
+        parsingInfo->COFFOffset = parsingInfo->peOffset + 4;
+        parseCOFF(parsingInfo->COFFOffset);
+
+        // OptionalHeader is right after COFFHeader
+        parsingInfo->OptionalHeaderOffset = parsingInfo->COFFOffset + sizeof(COFFHeader);
+
+        // OptionalHeader start determines if the file is 32 or 64 bit
+        uint16_t magic = 0;
+        seek(parsingInfo->OptionalHeaderOffset);
+        infile->read((char *)&magic, sizeof(magic));
+        if (magic == 0x20b) {
+            parsingInfo->is64bit = true;
+            parsingInfo->numOfRVAandSizes = parsingInfo->OptionalHeaderOffset + sizeof(PE32PlusOptionalHeader) - 4;
+            parsingInfo->DataDirectoryOffset = parsingInfo->OptionalHeaderOffset + sizeof(PE32PlusOptionalHeader);
+
+        } else if (magic == 0x10b) {
+            parsingInfo->is64bit = false;
+            parsingInfo->numOfRVAandSizes = parsingInfo->OptionalHeaderOffset + sizeof(PE32OptionalHeader) - 4;
+            parsingInfo->DataDirectoryOffset = parsingInfo->OptionalHeaderOffset + sizeof(PE32OptionalHeader);
+        } else {
+            std::cerr << "Invalid OptionalHeader magic number. Terminating\n"; 
+            return 0;
+        }
+        parseOptionalHeader(parsingInfo->OptionalHeaderOffset);
+        // Parse number of RVA and sizes needed for data directories
+        seek(parsingInfo->numOfRVAandSizes);
+        infile->read((char *)&(parsingInfo->numOfRVAandSizes), sizeof(parsingInfo->numOfRVAandSizes));
+        parsingInfo->numOfRVAandSizes = getNumOfDataDirectories(parsingInfo->numOfRVAandSizes);
+        parseDataDirectories(parsingInfo->numOfRVAandSizes, parsingInfo->DataDirectoryOffset);
+
+        // Parse Section Headers
+        parseSectionTable(coffHeader->numOfSections, parsingInfo->COFFOffset + sizeof(COFFHeader) + coffHeader->sizeOfOptionalHeader);
+
+        // Truncated or still-being-written files might not have an import directory
+        if (dataDirectoryTable.size() > 1) {
+            parseImportTable(dataDirectoryTable[1], sectionTable);
+        }
+        if (dataDirectoryTable.size() > 6) {
+            parseDebugDirectory(dataDirectoryTable[6]);
+        }
+        if (dataDirectoryTable.size() > 9) {
+            parseTLSDirectory(dataDirectoryTable[9]);
+        }
+        if (dataDirectoryTable.size() > 10) {
+            parseLoadConfig(dataDirectoryTable[10]);
+        }
+        
+        return 1;
+    }
+
+    void printAllInfo() {
+        std::cout << std::hex << std::setfill('0');
+
+        printCOFFHeaderInfo(&*this->coffHeader);
+        if (this->parsingInfo->is64bit) {
+            printOptionalHeader(&*this->optionalHeader64bit);
+        } else {
+            printOptionalHeader(&*this->optionalHeader32bit);
+        }
+        printDataDirectories(dataDirectoryTable, parsingInfo->numOfRVAandSizes);
+        printSectionTableInfo(sectionTable, coffHeader->numOfSections);
+        printImports(imports);
+        printDebugDirectory(debugDirectory, codeView, pogoEntries, reproHash);
+        printTLSDirectory(tlsDirectory, tlsCallbacks);
+        printLoadConfig(loadConfig, guardFlagsField);
+    }
+    
+    COFFHeader *getCOFFHeader() {
+        return &*coffHeader;
+    }
+
+    bool is64bit() {
+        return parsingInfo->is64bit;
+    }
+
+    PE32OptionalHeader *getOptionalHeader32() {
+        return &*optionalHeader32bit;
+    }
+
+    PE32PlusOptionalHeader *getOptionalHeader64() {
+        return &*optionalHeader64bit;
+    }
+
+    std::vector<ImageDataDirectoryEntry> &getDataDirectories() {
+        return dataDirectoryTable;
+    }
+
+    std::vector<SectionTableEntry> &getSectionTable() {
+        return sectionTable;
+    }
+
+    std::map<DllNameFunctionNumber, std::vector<HintTableEntry>> &getImports() {
+        return imports;
+    }
+
+    // Hash of the raw data of every section in section table order, read in chunks
+    // so that a bogus sizeOfRawData can't make us allocate the whole size at once
+    std::vector<uint64_t> hashSections() {
+        const size_t chunkSize = 1 << 20;
+        std::vector<uint64_t> hashes;
+        std::unique_ptr<char[]> buffer = std::make_unique<char[]>(chunkSize);
+        for (SectionTableEntry section : sectionTable) {
+            uint64_t hash = hashBytes(NULL, 0);
+            uint32_t remaining = section.sizeOfRawData;
+            infile->clear();
+            seek(section.pToRawData);
+            while (remaining > 0 && infile->good()) {
+                infile->read(buffer.get(), std::min<size_t>(chunkSize, remaining));
+                hash = hashBytes(buffer.get(), infile->gcount(), hash);
+                remaining -= infile->gcount();
+            }
+            hashes.push_back(hash);
+        }
+        infile->clear();
+        return hashes;
+    }
+
+    // One line overview of the file, used when parsing many files at once
+    std::string getSummary(const std::string &path) {
+        uint32_t entryPoint = parsingInfo->is64bit ? optionalHeader64bit->standardHead.addressOfEntryPoint : optionalHeader32bit->standardHead.addressOfEntryPoint;
+        return getSummaryLine(path, &*coffHeader, parsingInfo->is64bit, entryPoint, imports);
+    }
+
+    Parser(std::ifstream *infile) {
+        this->infile = infile;
+
+        // Fills up initial offsets and info
+        int valid = initialParse();
+
+        if (!valid) {
+            throw std::invalid_argument("Parsing Error"); // TODO
+        }
+
+
+    }
+};
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef SYMBOLS
+#define SYMBOLS
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "../utils/pe-lab-lib.h"
+
+// Size of a symbol or auxiliary record on disk
+const size_t symbolRecordSize = 18;
+
+static_assert(sizeof(COFFSymbol) == symbolRecordSize, "COFFSymbol must match the on disk record");
+
+// Storage class used by .file symbols, their name is stored in the auxiliary records
+const uint8_t storageClassFile = 103;
+
+// Only symbols matching every set field are visited
+struct SymbolFilter {
+    std::optional<uint8_t> storageClass;
+    std::optional<int16_t> sectionNumber;
+};
+
+// A symbol as handed out while walking the table. Name and aux point into the table
+// itself and are only valid as long as the SymbolTable is.
+struct SymbolView {
+    uint32_t index; // Index of the record in the table, counting auxiliary records
+    COFFSymbol symbol;
+    std::string_view name;
+    const char *aux; // First auxiliary record, numOfAuxSymbols records long
+};
+
+// Symbol table and the string table right after it, kept exactly as they are in the file
+class SymbolTable {
+    std::vector<char> data;
+    uint32_t numOfSymbols = 0;
+
+    std::string_view getName(const char *record) const {
+        uint32_t zeroes;
+        memcpy(&zeroes, record, sizeof(zeroes));
+        if (zeroes != 0) {
+            return std::string_view(record, strnlen(record, 8));
+        }
+        // Long names are an offset into the string table, which starts with its own size
+        uint32_t offset;
+        memcpy(&offset, record + 4, sizeof(offset));
+        size_t stringTableOffset = (size_t)numOfSymbols * symbolRecordSize;
+        size_t stringTableSize = data.size() - stringTableOffset;
+        if (offset < sizeof(uint32_t) || offset >= stringTableSize) {
+            return std::string_view();
+        }
+        const char *name = data.data() + stringTableOffset + offset;
+        return std::string_view(name, strnlen(name, stringTableSize - offset));
+    }
+
+public:
+    // Takes the raw bytes of the symbol table followed by the string table
+    void assign(std::vector<char> &&data, uint32_t numOfSymbols) {
+        this->data = std::move(data);
+        this->numOfSymbols = numOfSymbols;
+    }
+
+    uint32_t size() const {
+        return numOfSymbols;
+    }
+
+    // Calls callback(const SymbolView &) for every matching symbol in one pass over the table,
+    // auxiliary records are skipped over and handed to the callback with their symbol
+    template <typename Callback>
+    void forEachSymbol(const SymbolFilter &filter, Callback callback) const {
+        SymbolView view;
+        for (uint32_t i = 0; i < numOfSymbols; i += 1 + view.symbol.numOfAuxSymbols) {
+            const char *record = data.data() + (size_t)i * symbolRecordSize;
+            memcpy(&view.symbol, record, sizeof(COFFSymbol));
+            if (view.symbol.numOfAuxSymbols > numOfSymbols - i - 1) {
+                // Auxiliary records running past the end of the table, the table is corrupt
+                view.symbol.numOfAuxSymbols = numOfSymbols - i - 1;
+            }
+            if (filter.storageClass && *filter.storageClass != view.symbol.storageClass) {
+                continue;
+            }
+            if (filter.sectionNumber && *filter.sectionNumber != view.symbol.sectionNumber) {
+                continue;
+            }
+            view.index = i;
+            view.name = getName(record);
+            view.aux = record + symbolRecordSize;
+            callback(view);
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,359 @@
+// ****************************************************************
+// * Watch mode: parses samples as soon as they are written into  *
+// * a directory. New files are reported by inotify, parsed by a  *
+// * pool of workers and the results are written out in batches   *
+// ****************************************************************
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "parser.h"
+#include "watch.h"
+
+#ifdef __linux__
+
+#include <dirent.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/inotify.h>
+#include <sys/signalfd.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// Paths waiting to be parsed, filled by the inotify loop and drained by the workers
+class WorkQueue {
+    std::mutex lock;
+    std::condition_variable ready;
+    std::deque<std::string> paths;
+    bool closed = false;
+
+public:
+    void push(std::vector<std::string> &batch) {
+        if (batch.empty()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            for (std::string &path : batch) {
+                paths.push_back(std::move(path));
+            }
+        }
+        batch.clear();
+        ready.notify_all();
+    }
+
+    // Blocks until there is a path to parse, returns false once the queue is closed and empty
+    bool pop(std::string &path) {
+        std::unique_lock<std::mutex> guard(lock);
+        ready.wait(guard, [this] { return !paths.empty() || closed; });
+        if (paths.empty()) {
+            return false;
+        }
+        path = std::move(paths.front());
+        paths.pop_front();
+        return true;
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            closed = true;
+        }
+        ready.notify_all();
+    }
+};
+
+// Collects result lines from the workers. A burst of files is coalesced into one buffer
+// which is then written to stdout with a single write call.
+class BatchWriter {
+    // How long to wait for the rest of a burst before flushing
+    const std::chrono::milliseconds coalesceWindow{2};
+    // Flush early once this much output is pending
+    const size_t maxBatchSize = 64 * 1024;
+
+    std::mutex lock;
+    std::condition_variable ready;
+    std::string pending;
+    bool closed = false;
+    std::thread flusher;
+
+    void writeAll(const std::string &batch) {
+        size_t written = 0;
+        while (written < batch.size()) {
+            ssize_t n = write(STDOUT_FILENO, batch.data() + written, batch.size() - written);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+            written += n;
+        }
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> guard(lock);
+        while (true) {
+            ready.wait(guard, [this] { return !pending.empty() || closed; });
+            if (pending.empty()) {
+                return;
+            }
+            if (!closed && pending.size() < maxBatchSize) {
+                ready.wait_for(guard, coalesceWindow, [this] { return closed || pending.size() >= maxBatchSize; });
+            }
+            std::string batch;
+            batch.swap(pending);
+            guard.unlock();
+            writeAll(batch);
+            guard.lock();
+        }
+    }
+
+public:
+    BatchWriter() {
+        flusher = std::thread(&BatchWriter::run, this);
+    }
+
+    void append(const std::string &line) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            pending += line;
+        }
+        ready.notify_one();
+    }
+
+    // Flushes whatever is still pending and stops the flusher thread
+    void close() {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            closed = true;
+        }
+        ready.notify_one();
+        flusher.join();
+    }
+};
+
+static std::string parseSample(const std::string &path) {
+    std::ifstream infile;
+    infile.open(path, std::ios::in | std::ios::binary);
+    if (!infile) {
+        return path + "\terror: could not open file\n";
+    }
+    try {
+        Parser parser(&infile);
+        return parser.getSummary(path);
+    } catch (const std::exception &e) {
+        return path + "\terror: " + e.what() + "\n";
+    }
+}
+
+static void worker(WorkQueue *queue, BatchWriter *writer) {
+    std::string path;
+    while (queue->pop(path)) {
+        writer->append(parseSample(path));
+    }
+}
+
+// Identifies one version of a file, a file rewritten in place gets a new mtime
+struct FileKey {
+    dev_t dev;
+    ino_t ino;
+    time_t mtimeSec;
+    long mtimeNsec;
+
+    bool operator <(const FileKey &other) const {
+        if (dev != other.dev) return dev < other.dev;
+        if (ino != other.ino) return ino < other.ino;
+        if (mtimeSec != other.mtimeSec) return mtimeSec < other.mtimeSec;
+        return mtimeNsec < other.mtimeNsec;
+    }
+};
+
+// Only touched by the inotify loop, so no locking needed
+struct WatchState {
+    std::string root;
+    std::set<FileKey> queued; // Every file version already handed to the workers
+    std::vector<std::string> deferred; // Files found while scanning that were modified too recently
+};
+
+// Files modified more recently than this while scanning might still be written to,
+// they are picked up by their close event or once they have been left alone this long
+const std::chrono::milliseconds settleTime{50};
+
+static FileKey getFileKey(const struct stat &st) {
+    return {st.st_dev, st.st_ino, st.st_mtim.tv_sec, st.st_mtim.tv_nsec};
+}
+
+static bool isSettled(const struct stat &st) {
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    int64_t age = (int64_t)(now.tv_sec - st.st_mtim.tv_sec) * 1000000000 + (now.tv_nsec - st.st_mtim.tv_nsec);
+    return age >= std::chrono::duration_cast<std::chrono::nanoseconds>(settleTime).count();
+}
+
+// Adds path to batch unless this version of it was queued before. Recently modified files are deferred.
+static void queueIfNew(WatchState *state, const std::string &path, std::vector<std::string> *batch, bool deferRecent) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return;
+    }
+    FileKey key = getFileKey(st);
+    if (state->queued.count(key)) {
+        return;
+    }
+    if (deferRecent && !isSettled(st)) {
+        state->deferred.push_back(path);
+        return;
+    }
+    state->queued.insert(key);
+    batch->push_back(path);
+}
+
+// Queues every regular file in the directory that wasn't queued already, used on
+// startup and after inotify dropped events
+static void catchUp(WatchState *state, WorkQueue *queue) {
+    DIR *dir = opendir(state->root.c_str());
+    if (dir == NULL) {
+        return;
+    }
+    std::vector<std::string> batch;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (entry->d_type != DT_REG && entry->d_type != DT_UNKNOWN) {
+            continue;
+        }
+        queueIfNew(state, state->root + "/" + entry->d_name, &batch, true);
+    }
+    closedir(dir);
+    queue->push(batch);
+}
+
+// Queues deferred files that have settled without a close event queuing them first
+static void checkDeferred(WatchState *state, WorkQueue *queue) {
+    std::vector<std::string> deferred;
+    deferred.swap(state->deferred);
+    std::vector<std::string> batch;
+    for (std::string &path : deferred) {
+        queueIfNew(state, path, &batch, true);
+    }
+    queue->push(batch);
+}
+
+int watchDirectory(const char *directory) {
+    WatchState state;
+    state.root = directory;
+
+    int inotifyFd = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+    if (inotifyFd < 0) {
+        std::cerr << "Could not initialize inotify" << std::endl;
+        return 1;
+    }
+    // The watch is added before catching up so that nothing landing in between is missed
+    if (inotify_add_watch(inotifyFd, directory, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        std::cerr << "Could not watch directory " << directory << std::endl;
+        close(inotifyFd);
+        return 1;
+    }
+
+    // Signals are blocked before any thread starts so they are only delivered through signalFd
+    sigset_t mask, oldMask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, &oldMask);
+    int signalFd = signalfd(-1, &mask, SFD_CLOEXEC);
+    if (signalFd < 0) {
+        std::cerr << "Could not create signalfd" << std::endl;
+        pthread_sigmask(SIG_SETMASK, &oldMask, NULL);
+        close(inotifyFd);
+        return 1;
+    }
+
+    WorkQueue queue;
+    BatchWriter writer;
+    unsigned int numOfWorkers = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < numOfWorkers; i++) {
+        workers.emplace_back(worker, &queue, &writer);
+    }
+
+    catchUp(&state, &queue);
+
+    alignas(struct inotify_event) char buffer[64 * 1024];
+    std::vector<std::string> batch;
+    struct pollfd fds[2] = {{inotifyFd, POLLIN, 0}, {signalFd, POLLIN, 0}};
+    bool running = true;
+    while (running) {
+        int timeout = state.deferred.empty() ? -1 : settleTime.count();
+        int ready = poll(fds, 2, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        if (ready == 0) {
+            checkDeferred(&state, &queue);
+            continue;
+        }
+        if (fds[1].revents & POLLIN) {
+            break;
+        }
+        if (!(fds[0].revents & POLLIN)) {
+            continue;
+        }
+
+        // Drain everything inotify has for us so a burst of files is queued as one batch
+        ssize_t len;
+        while ((len = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+            for (char *p = buffer; p < buffer + len; p += sizeof(struct inotify_event) + ((struct inotify_event *)p)->len) {
+                struct inotify_event *event = (struct inotify_event *)p;
+                if (event->mask & IN_Q_OVERFLOW) {
+                    // Events were dropped, rescan the whole directory instead
+                    queue.push(batch);
+                    catchUp(&state, &queue);
+                } else if (event->mask & IN_IGNORED) {
+                    // Directory was deleted or unmounted
+                    running = false;
+                } else if (event->len > 0 && !(event->mask & IN_ISDIR)) {
+                    // A close event always means a complete file, it is only skipped if exactly
+                    // this version was already queued, eg. by the startup scan
+                    queueIfNew(&state, state.root + "/" + event->name, &batch, false);
+                }
+            }
+        }
+        queue.push(batch);
+        if (!state.deferred.empty()) {
+            checkDeferred(&state, &queue);
+        }
+    }
+
+    queue.close();
+    for (std::thread &t : workers) {
+        t.join();
+    }
+    writer.close();
+    close(signalFd);
+    close(inotifyFd);
+    return 0;
+}
+
+#else
+
+int watchDirectory(const char *directory) {
+    std::cerr << "Watch mode is only supported on Linux" << std::endl;
+    return 1;
+}
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef WATCH
+#define WATCH
+
+// Watches a spool directory and prints a summary line for every PE file that lands in it.
+// Files already in the directory are parsed first. Runs until SIGINT or SIGTERM.
+int watchDirectory(const char *directory);
+
+#endif
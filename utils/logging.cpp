@@ -6,9 +6,12 @@
 #include "pe-lab-lib.h"
 #include "utils.h"
 #include "string.h"
+#include <strings.h>
+#include <cstdlib>
 #include <map>
 #include <cstdint>
 #include <iomanip>
+#include <sstream>
 #include <vector>
 
 std::map<uint16_t, const char *> machineType = {
@@ -58,6 +61,57 @@ std::map<uint16_t, const char *> subsystem = {
     {16, "Windows Boot Application"}
 };
 
+std::map<uint32_t, const char *> debugType = {
+    {0, "Unknown"},
+    {1, "COFF"},
+    {2, "CodeView"},
+    {3, "FPO"},
+    {4, "Misc"},
+    {5, "Exception"},
+    {6, "Fixup"},
+    {7, "OMAP to source"},
+    {8, "OMAP from source"},
+    {9, "Borland"},
+    {10, "Reserved"},
+    {11, "CLSID"},
+    {12, "VC Feature"},
+    {13, "POGO"},
+    {14, "ILTCG"},
+    {15, "MPX"},
+    {16, "Repro"},
+    {20, "Extended DLL characteristics"}
+};
+
+std::map<uint8_t, const char *> storageClassName = {
+    {0, "Null"},
+    {1, "Automatic"},
+    {2, "External"},
+    {3, "Static"},
+    {4, "Register"},
+    {5, "External def"},
+    {6, "Label"},
+    {7, "Undefined label"},
+    {8, "Struct member"},
+    {9, "Argument"},
+    {10, "Struct tag"},
+    {11, "Union member"},
+    {12, "Union tag"},
+    {13, "Type definition"},
+    {14, "Undefined static"},
+    {15, "Enum tag"},
+    {16, "Enum member"},
+    {17, "Register param"},
+    {18, "Bit field"},
+    {100, "Block"},
+    {101, "Function"},
+    {102, "End of struct"},
+    {103, "File"},
+    {104, "Section"},
+    {105, "Weak external"},
+    {107, "CLR token"},
+    {255, "End of function"}
+};
+
 void printWithPad(const char* startString, uint64_t toPrint, int maxSize) {
     std::cout << startString << std::setfill('.') << std::setw(maxSize - strlen(startString) + 1) << " " << std::setfill('0') << "0x" << std::setw(8) << toPrint << "\n";  
 }
@@ -181,13 +235,18 @@ void printOptionalHeader(PE32PlusOptionalHeader *header) {
     std::cout << "  [*] Number of Rva and Sizes: " << "0x" << std::setw(8) << header->winHead.numOfRvaAndSizes<< std::endl;
 }
 
+const char *dataDirectoryName[] = {"Export Table", "Import Table", "Resource Table", "Exception Table", "Certificate Table", "Base Relocation Table", "Debug", "Architecture", "Global Ptr", "TLS Table", "Load Config Table", "Bound Import", "IAT", "Delay Import Descriptor", "CLR Runtime Header", "Reserved"};
+
+const char *getDataDirectoryName(uint32_t index) {
+    return index < sizeof(dataDirectoryName) / sizeof(dataDirectoryName[0]) ? dataDirectoryName[index] : "Unknown";
+}
+
 void printDataDirectories(std::vector<ImageDataDirectoryEntry> entries, uint32_t numOf) {
     std::cout << " +---------------------------------------------------------------------------+" << std::endl;
     std::cout << " |##########            Optional Header Data Directories           ##########|" << std::endl;
     std::cout << " +---------------------------------------------------------------------------+" << std::endl;
-    std::string table[] = {"Export Table", "Import Table", "Resource Table", "Exception Table", "Certificate Table", "Base Relocation Table", "Debug", "Architecture", "Global Ptr", "TLS Table", "Load Config Table", "Bound Import", "IAT", "Delay Import Descriptor", "CLR Runtime Header"};
-    for (uint32_t i = 0; i < numOf - 1; i++) {
-        std::cout << "  [*] " << table[i] << "\n";
+    for (uint32_t i = 0; i + 1 < numOf; i++) {
+        std::cout << "  [*] " << getDataDirectoryName(i) << "\n";
         printWithPad("    RVA", entries[i].VA, 8);
         printWithPad("    Size", entries[i].size, 8);
         std::cout << "\n";
@@ -221,3 +280,164 @@ void printImports(std::map<DllNameFunctionNumber, std::vector<HintTableEntry>> i
         std::cout << "\n";
     }
 }
+
+void printDebugDirectory(std::vector<DebugDirectoryEntry> entries, std::vector<CodeViewInfo> codeView, std::vector<PogoEntry> pogoEntries, std::vector<uint8_t> reproHash) {
+    if (entries.empty()) {
+        return;
+    }
+    std::cout << " +---------------------------------------------------------------------------+" << std::endl;
+    std::cout << " |##########                    Debug Directory                    ##########|" << std::endl;
+    std::cout << " +---------------------------------------------------------------------------+\n" << std::endl;
+    for (DebugDirectoryEntry &entry : entries) {
+        std::map<uint32_t, const char *>::iterator type = debugType.find(entry.type);
+        std::cout << "  [*] " << (type != debugType.end() ? type->second : "Unknown") << "\n";
+        printWithPad("    [+] Time created ", entry.timeDateStamp, 28);
+        printWithPad("    [+] Size of data ", entry.sizeOfData, 28);
+        printWithPad("    [+] Addr of raw data ", entry.addressOfRawData, 28);
+        printWithPad("    [+] Pointer to raw data ", entry.pToRawData, 28);
+        std::cout << "\n";
+    }
+
+    for (CodeViewInfo &info : codeView) {
+        if (info.cvSignature == 0x53445352) {
+            std::string guid = formatGUID(info.guid);
+            // Key used by symbol servers to find the PDB, the GUID without separators followed by the age
+            std::string key = "";
+            for (char c : guid) {
+                if (isxdigit(c)) {
+                    key += c;
+                }
+            }
+            std::ostringstream age;
+            age << std::uppercase << std::hex << info.age;
+            printWithPad("  [*] CodeView ", "RSDS", 24);
+            printWithPad("  [*] GUID ", guid.c_str(), 24);
+            printWithPad("  [*] Age ", info.age, 24);
+            printWithPad("  [*] Symbol server key ", (key + age.str()).c_str(), 24);
+        } else {
+            printWithPad("  [*] CodeView ", "NB10", 24);
+            printWithPad("  [*] Signature ", info.nb10Signature, 24);
+            printWithPad("  [*] Age ", info.age, 24);
+        }
+        printWithPad("  [*] PDB path ", info.pdbPath.c_str(), 24);
+        std::cout << "\n";
+    }
+
+    if (!pogoEntries.empty()) {
+        std::cout << "  [*] POGO\n";
+        std::cout << "  +-----------------------------------------+\n";
+        std::cout << "  |\tRVA         SIZE        NAME          |\n";
+        std::cout << "  +-----------------------------------------+\n";
+        for (PogoEntry &entry : pogoEntries) {
+            std::cout << "\t0x" << std::hex << std::setfill('0') << std::setw(8) << entry.rva << "  0x" << std::setw(8) << entry.size << "  " << entry.name << "\n";
+        }
+        std::cout << "\n";
+    }
+
+    if (!reproHash.empty()) {
+        std::ostringstream hash;
+        hash << std::hex << std::setfill('0');
+        for (uint8_t byte : reproHash) {
+            hash << std::setw(2) << (int)byte;
+        }
+        printWithPad("  [*] Repro hash ", hash.str().c_str(), 24);
+        std::cout << "\n";
+    }
+}
+
+void printTLSDirectory(std::vector<DirectoryField> fields, std::vector<uint64_t> callbacks) {
+    if (fields.empty()) {
+        return;
+    }
+    std::cout << " +---------------------------------------------------------------------------+" << std::endl;
+    std::cout << " |##########                     TLS Directory                     ##########|" << std::endl;
+    std::cout << " +---------------------------------------------------------------------------+" << std::endl;
+    for (DirectoryField &field : fields) {
+        printWithPad(("  [*] " + std::string(field.name) + " ").c_str(), field.value, 29);
+    }
+    std::cout << "\n  [*] " << std::dec << callbacks.size() << " callback(s)\n";
+    for (uint64_t callback : callbacks) {
+        std::cout << "\t0x" << std::hex << std::setfill('0') << std::setw(8) << callback << "\n";
+    }
+    std::cout << "\n";
+}
+
+// guardFlagsIndex is the position of GuardFlags in the load config layout, its bits are named as well
+void printLoadConfig(std::vector<DirectoryField> fields, size_t guardFlagsIndex) {
+    if (fields.empty()) {
+        return;
+    }
+    std::cout << " +---------------------------------------------------------------------------+" << std::endl;
+    std::cout << " |##########                   Load Config Table                   ##########|" << std::endl;
+    std::cout << " +---------------------------------------------------------------------------+" << std::endl;
+    for (size_t i = 0; i < fields.size(); i++) {
+        printWithPad(("  [*] " + std::string(fields[i].name) + " ").c_str(), fields[i].value, 48);
+        if (i == guardFlagsIndex) {
+            printWithPad("      Guard flags ", getGuardFlags(fields[i].value).c_str(), 48);
+        }
+    }
+    std::cout << "\n";
+}
+
+void printSymbolTableHeader(uint32_t numOfSymbols) {
+    std::cout << " +---------------------------------------------------------------------------+" << std::endl;
+    std::cout << " |##########                   COFF Symbol Table                   ##########|" << std::endl;
+    std::cout << " +---------------------------------------------------------------------------+\n" << std::endl;
+    std::cout << "  [*] " << std::dec << numOfSymbols << " record(s)\n\n" << std::hex;
+    std::cout << "  INDEX     VALUE     SECTION TYPE CLASS            AUX NAME\n";
+}
+
+// Called once per symbol, so nothing in here allocates
+void printSymbol(uint32_t index, const COFFSymbol *symbol, std::string_view name) {
+    std::map<uint8_t, const char *>::iterator storageClass = storageClassName.find(symbol->storageClass);
+    std::cout << "  " << std::setfill('0') << std::setw(8) << index << "  " << std::setw(8) << symbol->value << "  ";
+    if (symbol->sectionNumber > 0) {
+        std::cout << std::setfill(' ') << std::setw(7) << std::dec << symbol->sectionNumber << std::hex;
+    } else {
+        std::cout << std::setfill(' ') << std::setw(7) << (symbol->sectionNumber == 0 ? "UNDEF" : symbol->sectionNumber == -1 ? "ABS" : "DEBUG");
+    }
+    std::cout << " " << std::setfill('0') << std::setw(4) << symbol->type << " " << std::setfill(' ') << std::left << std::setw(16);
+    if (storageClass != storageClassName.end()) {
+        std::cout << storageClass->second;
+    } else {
+        std::cout << (int)symbol->storageClass;
+    }
+    std::cout << std::right << " " << std::setw(3) << std::dec << (int)symbol->numOfAuxSymbols << std::hex << " " << name << "\n";
+}
+
+// Accepts either the number of the storage class or its name, case insensitive
+bool findStorageClass(const std::string &name, uint8_t *storageClass) {
+    char *end;
+    unsigned long number = strtoul(name.c_str(), &end, 0);
+    if (!name.empty() && *end == '\0' && number <= 0xff) {
+        *storageClass = number;
+        return true;
+    }
+    for (std::map<uint8_t, const char *>::iterator it = storageClassName.begin(); it != storageClassName.end(); it++) {
+        if (strcasecmp(it->second, name.c_str()) == 0) {
+            *storageClass = it->first;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Tab separated so the output of watch mode can be consumed line by line by other tools.
+// Lookups use find() since this can be called from several threads at once.
+std::string getSummaryLine(const std::string &path, COFFHeader *header, bool is64bit, uint32_t entryPoint, const std::map<DllNameFunctionNumber, std::vector<HintTableEntry>> &imports) {
+    std::map<uint16_t, const char *>::iterator machine = machineType.find(header->machine);
+    size_t numOfFunctions = 0;
+    for (std::map<DllNameFunctionNumber, std::vector<HintTableEntry>>::const_iterator it = imports.begin(); it != imports.end(); it++) {
+        numOfFunctions += it->second.size();
+    }
+
+    std::ostringstream line;
+    line << path << "\t" << (machine != machineType.end() ? machine->second : "Machine Unknown");
+    line << "\t" << (is64bit ? "PE32+" : "PE32");
+    line << "\t" << std::dec << header->numOfSections << " section(s)";
+    line << "\t" << imports.size() << " dll(s)";
+    line << "\t" << numOfFunctions << " function(s)";
+    line << "\t" << "entry 0x" << std::hex << std::setfill('0') << std::setw(8) << entryPoint;
+    line << "\t" << "time 0x" << std::setw(8) << header->timeDateStamp << "\n";
+    return line.str();
+}
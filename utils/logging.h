@@ -3,6 +3,9 @@
 
 #include "pe-lab-lib.h"
 #include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
 #include <vector>
 
 void printCOFFHeaderInfo(COFFHeader *header);
@@ -10,7 +13,15 @@ void printOptionalHeader(PE32OptionalHeader *header);
 std::string getSectionEntryChars(SectionTableEntry *entry);
 void printSectionTableInfo(std::vector<SectionTableEntry> entries, uint32_t len);
 void printOptionalHeader(PE32PlusOptionalHeader *header); 
+const char *getDataDirectoryName(uint32_t index);
 void printDataDirectories(std::vector<ImageDataDirectoryEntry> entries, uint32_t numOf);
 void printImports(std::map<DllNameFunctionNumber, std::vector<HintTableEntry>> imports); 
+void printDebugDirectory(std::vector<DebugDirectoryEntry> entries, std::vector<CodeViewInfo> codeView, std::vector<PogoEntry> pogoEntries, std::vector<uint8_t> reproHash);
+void printTLSDirectory(std::vector<DirectoryField> fields, std::vector<uint64_t> callbacks);
+void printLoadConfig(std::vector<DirectoryField> fields, size_t guardFlagsIndex);
+void printSymbolTableHeader(uint32_t numOfSymbols);
+void printSymbol(uint32_t index, const COFFSymbol *symbol, std::string_view name);
+bool findStorageClass(const std::string &name, uint8_t *storageClass);
+std::string getSummaryLine(const std::string &path, COFFHeader *header, bool is64bit, uint32_t entryPoint, const std::map<DllNameFunctionNumber, std::vector<HintTableEntry>> &imports);
 
 #endif
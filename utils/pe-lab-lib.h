@@ -7,6 +7,7 @@
 
 #include <cstdint>
 #include <fstream>
+#include <string>
 
 // Each entry points to a structure windows uses such as the import or the export table
 struct ImageDataDirectoryEntry {
@@ -25,6 +26,19 @@ struct COFFHeader{
     uint16_t characteristics; // Flag that indicate attributes of the file (eg. is the binary stripped, if its a DLL...)
 };
 
+// Entry of the COFF symbol table. Records are 18 bytes and follow each other without padding,
+// a record with numOfAuxSymbols > 0 is followed by that many 18 byte auxiliary records
+#pragma pack(push, 1)
+struct COFFSymbol {
+    uint8_t name[8]; // Short name, or 4 zero bytes followed by an offset into the string table
+    uint32_t value; // Meaning depends on section number and storage class, usually an offset into the section
+    int16_t sectionNumber; // 1 based index into the section table, 0 is undefined, -1 absolute and -2 debug
+    uint16_t type; // 0x20 if the symbol is a function
+    uint8_t storageClass; // Kind of symbol (eg. external, static, file)
+    uint8_t numOfAuxSymbols; // Number of auxiliary records following this one
+};
+#pragma pack(pop)
+
 // Part of the optional header defined for every COFF implementation
 struct PE32StandardHeader {
     uint16_t magic; // Detemines if a file is 32 or 64bit
@@ -143,6 +157,50 @@ struct ILTEntryPE32Plus {
     uint64_t bitField;
 };
 
+// Each entry in the debug directory describes one block of debug information
+struct DebugDirectoryEntry {
+    uint32_t characteristics; // Reserved, must be 0
+    uint32_t timeDateStamp; // Time the debug data was created
+    uint16_t majorVersion; // Version of the debug data format
+    uint16_t minorVersion; // self explanatory
+    uint32_t type; // Format of the debug data (eg. CodeView, POGO, Repro)
+    uint32_t sizeOfData; // Size of the debug data, not including the directory entry
+    uint32_t addressOfRawData; // RVA of the debug data when loaded, 0 if it is not mapped
+    uint32_t pToRawData; // File offset of the debug data
+};
+
+// CodeView record pointing to the PDB file, either the current RSDS or the old NB10 format
+struct CodeViewInfo {
+    uint32_t cvSignature; // 'RSDS' or 'NB10'
+    uint8_t guid[16]; // RSDS only, GUID as stored in the file
+    uint32_t nb10Signature; // NB10 only, time the PDB was created
+    uint32_t age; // Incremented every time the PDB is updated
+    std::string pdbPath; // Path of the PDB when the file was linked
+
+    CodeViewInfo() {}
+};
+
+// Entry of the POGO (profile guided optimization) debug data, one per contribution to a section
+struct PogoEntry {
+    uint32_t rva; // RVA of the contribution
+    uint32_t size; // Size of the contribution
+    std::string name; // Name of the section contribution (eg. .text$mn)
+
+    PogoEntry() {}
+    PogoEntry(uint32_t rva, uint32_t size, std::string name) {
+        this->rva = rva;
+        this->size = size;
+        this->name = name;
+    }
+};
+
+// Decoded field of a directory structure whose layout depends on its version (eg. load config)
+struct DirectoryField {
+    const char *name; // Name of the field as in the Windows headers
+    uint64_t value; // Value widened to 64 bits
+    uint8_t width; // Size of the field in the file in bytes
+};
+
 struct DllNameFunctionNumber {
     std::string name;
     int numOfFunctions;
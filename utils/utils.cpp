@@ -5,6 +5,9 @@
 // *************************************************
 
 #include <fstream>
+#include <cstdio>
+#include <cstring>
+#include "utils.h"
 
 char* getTime(uint32_t timestamp) {
     time_t a = timestamp;
@@ -51,6 +54,67 @@ std::string getDLLChars(uint16_t chars) {
     return ret;
 }
 
+std::string getGuardFlags(uint32_t flags) {
+    std::string ret = "";
+    if (flags & 0x00000100) {
+        ret += "CF instrumented, ";
+    }
+    if (flags & 0x00000200) {
+        ret += "CF write instrumented, ";
+    }
+    if (flags & 0x00000400) {
+        // Top 4 bits are the number of extra bytes after each RVA in the CF function table
+        ret += "CF function table (stride " + std::to_string(flags >> 28) + "), ";
+    }
+    if (flags & 0x00000800) {
+        ret += "Security cookie unused, ";
+    }
+    if (flags & 0x00001000) {
+        ret += "Protect delay load IAT, ";
+    }
+    if (flags & 0x00002000) {
+        ret += "Delay load IAT in own section, ";
+    }
+    if (flags & 0x00004000) {
+        ret += "CF export suppression info, ";
+    }
+    if (flags & 0x00008000) {
+        ret += "CF export suppression enabled, ";
+    }
+    if (flags & 0x00010000) {
+        ret += "CF longjump table, ";
+    }
+    if (flags & 0x00020000) {
+        ret += "RF instrumented, ";
+    }
+    if (flags & 0x00040000) {
+        ret += "RF enabled, ";
+    }
+    if (flags & 0x00080000) {
+        ret += "RF strict, ";
+    }
+    if (flags & 0x00100000) {
+        ret += "Retpoline, ";
+    }
+    if (flags & 0x00400000) {
+        ret += "EH continuation table, ";
+    }
+    if (flags & 0x00800000) {
+        ret += "XFG enabled, ";
+    }
+    if (flags & 0x01000000) {
+        ret += "CastGuard, ";
+    }
+    if (flags & 0x02000000) {
+        ret += "Memcpy guard, ";
+    }
+
+    if (ret.empty()) {
+        return "None";
+    }
+    return ret.substr(0, ret.size() - 2);
+}
+
 bool namecmp(uint8_t *name, const char *sectionName) {
     int i = 0;
     while (name[i] != 0 && i < 8) {
@@ -66,7 +130,9 @@ std::string readAscii(std::ifstream *infile, int offset) {
     int i = 0;
     while (c != 0) {
         infile->seekg(offset + i, std::ios::beg);
-        infile->read(&c, 1);
+        if (!infile->read(&c, 1)) {
+            break;
+        }
         ret += c;
         i++;
     }
@@ -88,3 +154,32 @@ std::string rtrim(const std::string &s) {
 std::string trim(const std::string &s) {
     return rtrim(ltrim(s));
 }
+
+// GUIDs are stored as a little endian uint32_t, two uint16_t and 8 single bytes
+std::string formatGUID(const uint8_t guid[16]) {
+    char ret[39];
+    snprintf(ret, sizeof(ret), "{%02X%02X%02X%02X-%02X%02X-%02X%02X-%02X%02X-%02X%02X%02X%02X%02X%02X}",
+        guid[3], guid[2], guid[1], guid[0], guid[5], guid[4], guid[7], guid[6],
+        guid[8], guid[9], guid[10], guid[11], guid[12], guid[13], guid[14], guid[15]);
+    return ret;
+}
+
+// FNV-1a style hash over 8 byte words, used to tell if two blocks of data differ.
+// The multiply only carries bits upwards, so the high half is folded back down after every
+// word, otherwise differences in the high bits of two words could cancel each other out.
+// Can be chained over chunks as long as every chunk but the last is a multiple of 8 bytes.
+uint64_t hashBytes(const char *data, size_t len, uint64_t hash) {
+    const uint64_t prime = 0x100000001b3;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 32;
+    }
+    for (; i < len; i++) {
+        hash = (hash ^ (uint8_t)data[i]) * prime;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
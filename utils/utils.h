@@ -1,6 +1,7 @@
 #ifndef UTILS
 #define UTILS
 
+#include <cstdint>
 #include <string>
 #include <fstream>
 #include <time.h>
@@ -9,10 +10,13 @@
 char* getTime(uint32_t timestamp);
 std::string getChars(uint16_t chars);
 std::string getDLLChars(uint16_t chars); 
+std::string getGuardFlags(uint32_t flags);
 bool namecmp(uint8_t *name, const char *sectionName);
 std::string readAscii(std::ifstream *infile, int offset);
 std::string ltrim(const std::string &s);
 std::string rtrim(const std::string &s);
 std::string trim(const std::string &s);
+std::string formatGUID(const uint8_t guid[16]);
+uint64_t hashBytes(const char *data, size_t len, uint64_t hash = 0xcbf29ce484222325);
 
 #endif